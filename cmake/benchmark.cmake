@@ -0,0 +1,21 @@
+cmake_minimum_required(VERSION 3.14 FATAL_ERROR)
+
+option(BUILD_BENCHMARK "Build the benchmark suite vcpwq_bench" OFF)
+
+if(BUILD_BENCHMARK)
+    # use an installed Google Benchmark if available, fetch it otherwise
+    find_package(benchmark QUIET)
+    if(NOT benchmark_FOUND)
+        include(FetchContent)
+        set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+        set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+        set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+        fetchcontent_declare(BENCHMARK
+                GIT_REPOSITORY https://github.com/google/benchmark.git
+                GIT_TAG "v1.8.3"
+                GIT_PROGRESS TRUE
+                )
+
+        fetchcontent_makeavailable(BENCHMARK)
+    endif()
+endif()
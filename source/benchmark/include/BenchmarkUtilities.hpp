@@ -0,0 +1,39 @@
+//=======================================================================
+/** @file BenchmarkUtilities.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Synthetic signals and common counters for the benchmark suite vcpwq_bench.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef BenchmarkUtilities_hpp
+#define BenchmarkUtilities_hpp
+
+#include <cstddef>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../../constants/constants.hpp"
+
+namespace VC_PWQ::Benchmark {
+
+static constexpr int BENCH_FS = FS_0;
+static constexpr size_t BENCH_SAMPLES = 10 * BENCH_FS;  // 10 s per channel
+static constexpr int BENCH_CHANNELS = 8;
+static constexpr int BENCH_BITBUDGET = 40;
+
+auto synthSignal(size_t length, int seed) -> std::vector<double>;
+auto synthChannels(size_t length, int channels) -> std::vector<std::vector<double>>;
+
+void blockLengths(benchmark::internal::Benchmark* bench);
+void setBlockCounters(benchmark::State& state, size_t samples, size_t blocks);
+
+}  // namespace VC_PWQ::Benchmark
+
+#endif /* BenchmarkUtilities_hpp */
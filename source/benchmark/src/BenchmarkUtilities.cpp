@@ -0,0 +1,85 @@
+//=======================================================================
+/** @file BenchmarkUtilities.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Synthetic signals and common counters for the benchmark suite vcpwq_bench.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/BenchmarkUtilities.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+namespace VC_PWQ::Benchmark {
+
+/**
+ * @brief deterministic vibrotactile test signal: two decaying texture tones, a noise component and silent gaps
+ * @details the generator does not depend on the standard library implementation, so all platforms measure the same
+ * signal
+ * @param length number of samples
+ * @param seed variation of frequencies and noise
+ * @return signal
+ */
+auto synthSignal(size_t length, int seed) -> std::vector<double> {
+    std::vector<double> sig(length);
+    uint64_t state = 0x9E3779B97F4A7C15ULL + (uint64_t)seed;
+    double f1 = 60 + 25 * seed;   // NOLINT
+    double f2 = 250 + 40 * seed;  // NOLINT
+    for (size_t i = 0; i < length; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;  // NOLINT
+        double noise = (double)(state >> 11) / 9007199254740992.0 - 0.5;  // NOLINT
+        double t = (double)i / BENCH_FS;
+        double phase = fmod(t, 1.0);  // a new contact every second
+        sig[i] = 0.6 * sin(2 * M_PI * f1 * t) + 0.3 * sin(2 * M_PI * f2 * t) * exp(-4 * phase) + 0.1 * noise;  // NOLINT
+        if (phase > 0.85) {                                                                                   // NOLINT
+            sig[i] = 0;
+        }
+    }
+    return sig;
+}
+
+/**
+ * @brief deterministic multichannel test signal
+ * @param length number of samples per channel
+ * @param channels number of channels
+ * @return one vector per channel
+ */
+auto synthChannels(size_t length, int channels) -> std::vector<std::vector<double>> {
+    std::vector<std::vector<double>> sig;
+    sig.reserve(channels);
+    for (int c = 0; c < channels; c++) {
+        sig.push_back(synthSignal(length, c));
+    }
+    return sig;
+}
+
+/**
+ * @brief register a benchmark for every supported block length
+ * @param bench benchmark
+ */
+void blockLengths(benchmark::internal::Benchmark* bench) {
+    for (int bl : {BL_0, BL_1, BL_2, BL_3, BL_4}) {
+        bench->Arg(bl);
+    }
+    bench->ArgName("bl");
+}
+
+/**
+ * @brief report throughput in samples/s (items_per_second) and the time per block (time_per_block, in seconds)
+ * @param state benchmark state after the timing loop
+ * @param samples samples processed per iteration
+ * @param blocks blocks processed per iteration
+ */
+void setBlockCounters(benchmark::State& state, size_t samples, size_t blocks) {
+    state.SetItemsProcessed(state.iterations() * (int64_t)samples);
+    state.counters["time_per_block"] = benchmark::Counter((double)state.iterations() * (double)blocks,
+                                                          benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+}  // namespace VC_PWQ::Benchmark
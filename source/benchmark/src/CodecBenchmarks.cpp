@@ -0,0 +1,88 @@
+//=======================================================================
+/** @file CodecBenchmarks.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Benchmarks of complete encoding and decoding of synthetic single channel and multichannel signals.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../../decoder/include/Decoder.hpp"
+#include "../../encoder/include/Encoder.hpp"
+#include "../include/BenchmarkUtilities.hpp"
+
+namespace VC_PWQ::Benchmark {
+
+static auto blockCount(size_t samples, int bl) -> size_t {
+    return (samples + bl - 1) / bl;
+}
+
+static void BM_Encode1D(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    std::vector<double> sig = synthSignal(BENCH_SAMPLES, 0);
+    Encoder encoder(bl, BENCH_FS);
+    size_t bits = 0;
+    for (auto _ : state) {
+        BitWriter bitstream = encoder.encode1D(sig, BENCH_BITBUDGET);
+        bits = bitstream.size();
+        benchmark::DoNotOptimize(bitstream.data());
+    }
+    setBlockCounters(state, BENCH_SAMPLES, blockCount(BENCH_SAMPLES, bl));
+    state.counters["bits"] = (double)bits;
+}
+BENCHMARK(BM_Encode1D)->Apply(blockLengths)->Unit(benchmark::kMillisecond);
+
+static void BM_Decode1D(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    std::vector<double> sig = synthSignal(BENCH_SAMPLES, 0);
+    Encoder encoder(bl, BENCH_FS);
+    const BitWriter bitstream = encoder.encode1D(sig, BENCH_BITBUDGET);
+    Decoder decoder;
+    for (auto _ : state) {
+        std::vector<double> decoded = decoder.decode1D(BitReader(bitstream));
+        benchmark::DoNotOptimize(decoded.data());
+    }
+    setBlockCounters(state, BENCH_SAMPLES, blockCount(BENCH_SAMPLES, bl));
+}
+BENCHMARK(BM_Decode1D)->Apply(blockLengths)->Unit(benchmark::kMillisecond);
+
+static void BM_EncodeMD(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    std::vector<std::vector<double>> sig = synthChannels(BENCH_SAMPLES, BENCH_CHANNELS);
+    Encoder encoder(bl, BENCH_FS);
+    size_t bits = 0;
+    for (auto _ : state) {
+        BitWriter bitstream = encoder.encodeMD(sig, BENCH_BITBUDGET);
+        bits = bitstream.size();
+        benchmark::DoNotOptimize(bitstream.data());
+    }
+    setBlockCounters(
+        state, BENCH_SAMPLES * BENCH_CHANNELS, blockCount(BENCH_SAMPLES, bl) * BENCH_CHANNELS);
+    state.counters["bits"] = (double)bits;
+}
+BENCHMARK(BM_EncodeMD)->Apply(blockLengths)->Unit(benchmark::kMillisecond);
+
+static void BM_DecodeMD(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    std::vector<std::vector<double>> sig = synthChannels(BENCH_SAMPLES, BENCH_CHANNELS);
+    Encoder encoder(bl, BENCH_FS);
+    const BitWriter bitstream = encoder.encodeMD(sig, BENCH_BITBUDGET);
+    Decoder decoder;
+    for (auto _ : state) {
+        std::vector<std::vector<double>> decoded = decoder.decodeMD(BitReader(bitstream));
+        benchmark::DoNotOptimize(decoded.data());
+    }
+    setBlockCounters(
+        state, BENCH_SAMPLES * BENCH_CHANNELS, blockCount(BENCH_SAMPLES, bl) * BENCH_CHANNELS);
+}
+BENCHMARK(BM_DecodeMD)->Apply(blockLengths)->Unit(benchmark::kMillisecond);
+
+}  // namespace VC_PWQ::Benchmark
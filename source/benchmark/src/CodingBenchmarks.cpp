@@ -0,0 +1,216 @@
+//=======================================================================
+/** @file CodingBenchmarks.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Benchmarks of the block encoder, SPIHT and the entropy coders.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../../encoder/include/Encoder.hpp"
+#include "../../losslessCoding/include/ArithDec.hpp"
+#include "../../losslessCoding/include/ArithEnc.hpp"
+#include "../../losslessCoding/include/SPIHT_Dec.hpp"
+#include "../../losslessCoding/include/SPIHT_Enc.hpp"
+#include "../include/BenchmarkUtilities.hpp"
+
+namespace VC_PWQ::Benchmark {
+
+static constexpr int SPIHT_BITS = 10;
+static constexpr size_t ENTROPY_SYMBOLS = 1 << 16;
+
+/**
+ * @brief encoder with access to the block functions
+ */
+class BlockEncoder : public Encoder {
+  public:
+    using Encoder::Encoder;
+    using Encoder::encodeBlock;
+    using Encoder::maximumWaveletCoefficient;
+};
+
+/**
+ * @brief wavelet coefficients of a test block together with SMR and band energy
+ */
+struct TestBlock {
+    TestBlock(int bl) : dwtlevel((int)log2(bl) - 2), SMR(dwtlevel + 1), bandenergy(dwtlevel + 1) {
+        PsychohapticModel pm;
+        pm.init(bl, BENCH_FS);
+        wavelet = synthSignal(bl, 0);
+        pm.getSMR(wavelet, SMR, bandenergy);
+        std::vector<double> scratch(bl);
+        DWT_inplace(wavelet.data(), bl, dwtlevel, scratch.data());
+    }
+
+    // integer coefficients with SPIHT_BITS bitplanes and the encoded maximum, as SPIHT_Enc expects them
+    void quantize(std::vector<int>& intquant, BitWriter& bitwavmax) {
+        double qwavmax = 0;
+        BlockEncoder::maximumWaveletCoefficient(wavelet, &qwavmax, &bitwavmax);
+        intquant.resize(wavelet.size());
+        for (size_t i = 0; i < wavelet.size(); i++) {
+            intquant[i] = (int)round(std::clamp(wavelet[i] / qwavmax, -1.0, 1.0) * ((1 << SPIHT_BITS) - 1));
+        }
+    }
+
+    int dwtlevel;
+    std::vector<double> wavelet;
+    std::vector<double> SMR;
+    std::vector<double> bandenergy;
+};
+
+static void BM_EncodeBlock(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    int bitbudget = (int)state.range(1);
+    BlockEncoder encoder(bl, BENCH_FS);
+    TestBlock block(bl);
+    BitWriter bitstream;
+    for (auto _ : state) {
+        bitstream.clear();
+        encoder.encodeBlock(block.wavelet, block.SMR, block.bandenergy, bitstream, bitbudget);
+        benchmark::DoNotOptimize(bitstream.data());
+    }
+    setBlockCounters(state, bl, 1);
+}
+BENCHMARK(BM_EncodeBlock)->ArgsProduct({{BL_1, BL_3, BL_4}, {10, 40, 70}})->ArgNames({"bl", "budget"});  // NOLINT
+
+static void BM_SPIHT_Enc(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    TestBlock block(bl);
+    std::vector<int> intquant;
+    BitWriter bitwavmax;
+    block.quantize(intquant, bitwavmax);
+
+    SPIHT_Enc spiht;
+    ArithEnc arithmetic;
+    BitWriter bitstream;
+    for (auto _ : state) {
+        bitstream.clear();
+        arithmetic.resetCounter();
+        arithmetic.start(&bitstream);
+        spiht.encode(intquant, block.dwtlevel, &bitwavmax, SPIHT_BITS, arithmetic);
+        arithmetic.finish();
+        benchmark::DoNotOptimize(bitstream.data());
+    }
+    setBlockCounters(state, bl, 1);
+    state.counters["bits"] = (double)bitstream.size();
+}
+BENCHMARK(BM_SPIHT_Enc)->Apply(blockLengths);
+
+static void BM_SPIHT_Dec(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    TestBlock block(bl);
+    std::vector<int> intquant;
+    BitWriter bitwavmax;
+    block.quantize(intquant, bitwavmax);
+
+    SPIHT_Enc spiht_enc;
+    ArithEnc arithmetic;
+    BitWriter bitstream;
+    arithmetic.start(&bitstream);
+    spiht_enc.encode(intquant, block.dwtlevel, &bitwavmax, SPIHT_BITS, arithmetic);
+    arithmetic.finish();
+
+    SPIHT_Dec spiht;
+    const BitReader reader(bitstream);
+    std::vector<int> decoded(bl);
+    double wavmax = 0;
+    int bitmax = 0;
+    for (auto _ : state) {
+        spiht.resetCounter();
+        spiht.decode(reader, 0, bitstream.size(), decoded, bl, block.dwtlevel, &wavmax, &bitmax);
+        benchmark::DoNotOptimize(decoded.data());
+    }
+    if (decoded != intquant) {
+        state.SkipWithError("SPIHT round trip failed");
+    }
+    setBlockCounters(state, bl, 1);
+}
+BENCHMARK(BM_SPIHT_Dec)->Apply(blockLengths);
+
+/**
+ * @brief symbols with context dependent probabilities, similar to the SPIHT output
+ */
+static void entropyTestSymbols(std::vector<int>& symbols, std::vector<int>& contexts) {
+    symbols.resize(ENTROPY_SYMBOLS);
+    contexts.resize(ENTROPY_SYMBOLS);
+    uint32_t state = 1;
+    for (size_t i = 0; i < ENTROPY_SYMBOLS; i++) {
+        state = state * 1664525U + 1013904223U;  // NOLINT
+        int context = (int)(i % (CONTEXT_REFINEMENT + 1));
+        uint32_t threshold = (uint32_t)(context + 1) << 28;  // p(1) from 1/16 to 7/16 NOLINT
+        contexts[i] = context;
+        symbols[i] = (int)(state < threshold);
+    }
+}
+
+static void BM_EntropyEncode(benchmark::State& state) {
+    auto coder = (EntropyCoder)state.range(0);
+    std::vector<int> symbols;
+    std::vector<int> contexts;
+    entropyTestSymbols(symbols, contexts);
+
+    ArithEnc arithmetic;
+    arithmetic.setCoder(coder);
+    BitWriter bitstream;
+    for (auto _ : state) {
+        bitstream.clear();
+        arithmetic.resetCounter();
+        arithmetic.start(&bitstream);
+        for (size_t i = 0; i < ENTROPY_SYMBOLS; i++) {
+            arithmetic.encodeSymbol(symbols[i], contexts[i]);
+        }
+        arithmetic.finish();
+        benchmark::DoNotOptimize(bitstream.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)ENTROPY_SYMBOLS);
+    state.counters["bits_per_symbol"] = (double)bitstream.size() / ENTROPY_SYMBOLS;
+    state.SetLabel(coder == EntropyCoder::RANGE ? "range" : "arithmetic");
+}
+BENCHMARK(BM_EntropyEncode)->Arg((int)EntropyCoder::ARITHMETIC)->Arg((int)EntropyCoder::RANGE)->ArgName("coder");
+
+static void BM_EntropyDecode(benchmark::State& state) {
+    auto coder = (EntropyCoder)state.range(0);
+    std::vector<int> symbols;
+    std::vector<int> contexts;
+    entropyTestSymbols(symbols, contexts);
+
+    ArithEnc arithmetic;
+    arithmetic.setCoder(coder);
+    BitWriter bitstream;
+    arithmetic.start(&bitstream);
+    for (size_t i = 0; i < ENTROPY_SYMBOLS; i++) {
+        arithmetic.encodeSymbol(symbols[i], contexts[i]);
+    }
+    arithmetic.finish();
+
+    ArithDec decoder;
+    decoder.setCoder(coder);
+    const BitReader reader(bitstream);
+    bool correct = true;
+    for (auto _ : state) {
+        decoder.resetCounter();
+        decoder.initDecoding(reader, 0, bitstream.size());
+        for (size_t i = 0; i < ENTROPY_SYMBOLS; i++) {
+            correct &= decoder.decode(contexts[i]) == symbols[i];
+        }
+    }
+    if (!correct) {
+        state.SkipWithError("entropy decoding failed");
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)ENTROPY_SYMBOLS);
+    state.SetLabel(coder == EntropyCoder::RANGE ? "range" : "arithmetic");
+}
+BENCHMARK(BM_EntropyDecode)->Arg((int)EntropyCoder::ARITHMETIC)->Arg((int)EntropyCoder::RANGE)->ArgName("coder");
+
+}  // namespace VC_PWQ::Benchmark
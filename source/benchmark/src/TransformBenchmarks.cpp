@@ -0,0 +1,92 @@
+//=======================================================================
+/** @file TransformBenchmarks.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Benchmarks of the wavelet transform and the psychohaptic model for a single block.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../../psychohapticModel/include/PeakFiltering.hpp"
+#include "../../psychohapticModel/include/PsychohapticModel.hpp"
+#include "../../wavelet/include/Wavelet.hpp"
+#include "../include/BenchmarkUtilities.hpp"
+
+namespace VC_PWQ::Benchmark {
+
+static void BM_DWT(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    int dwtlevel = (int)log2(bl) - 2;
+    std::vector<double> block = synthSignal(bl, 0);
+    std::vector<double> data(bl);
+    std::vector<double> scratch(bl);
+    for (auto _ : state) {
+        std::copy(block.begin(), block.end(), data.begin());
+        DWT_inplace(data.data(), bl, dwtlevel, scratch.data());
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    setBlockCounters(state, bl, 1);
+}
+BENCHMARK(BM_DWT)->Apply(blockLengths);
+
+static void BM_InvDWT(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    int dwtlevel = (int)log2(bl) - 2;
+    std::vector<double> block = synthSignal(bl, 0);
+    std::vector<double> scratch(bl);
+    DWT_inplace(block.data(), bl, dwtlevel, scratch.data());
+    std::vector<double> data(bl);
+    for (auto _ : state) {
+        std::copy(block.begin(), block.end(), data.begin());
+        inv_DWT_inplace(data.data(), bl, dwtlevel, scratch.data());
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    setBlockCounters(state, bl, 1);
+}
+BENCHMARK(BM_InvDWT)->Apply(blockLengths);
+
+static void BM_GetSMR(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    int l_book = (int)log2(bl) - 1;
+    PsychohapticModel pm;
+    pm.init(bl, BENCH_FS);
+    std::vector<double> block = synthSignal(bl, 0);
+    std::vector<double> SMR(l_book);
+    std::vector<double> bandenergy(l_book);
+    for (auto _ : state) {
+        pm.getSMR(block, SMR, bandenergy);
+        benchmark::DoNotOptimize(SMR.data());
+        benchmark::ClobberMemory();
+    }
+    setBlockCounters(state, bl, 1);
+}
+BENCHMARK(BM_GetSMR)->Apply(blockLengths);
+
+static void BM_FindPeaks(benchmark::State& state) {
+    int bl = (int)state.range(0);
+    std::vector<double> block = synthSignal(bl, 0);
+    std::vector<double> spect = PsychohapticModel::DCT(block);
+    double min_peak_height = findMaxVector(spect) - MIN_HEIGHT_DIFF;
+    PeakFiltering::PeakScratch scratch;
+    std::vector<peak> peaks;
+    for (auto _ : state) {
+        PeakFiltering::FindPeaks(spect, MIN_PEAK_PROMINENCE, min_peak_height, scratch, peaks);
+        benchmark::DoNotOptimize(peaks.data());
+    }
+    setBlockCounters(state, bl, 1);
+}
+BENCHMARK(BM_FindPeaks)->Apply(blockLengths);
+
+}  // namespace VC_PWQ::Benchmark
@@ -60,6 +60,15 @@ static constexpr size_t CONTEXTS = 7;
 static constexpr int RESET = 16;
 static constexpr int RESIZE = 32;
 
+// entropy coder backends; the range coder is signalled in the stream header
+enum class EntropyCoder { ARITHMETIC, RANGE };
+
+static constexpr int RC_PROB_BITS = 11;
+static constexpr int RC_PROB_INIT = 1 << (RC_PROB_BITS - 1);
+static constexpr int RC_MOVE_BITS = 5;
+static constexpr unsigned RC_TOP = 1U << 24;
+static constexpr int RC_BYTES = 4;
+
 }  // namespace VC_PWQ
 
 #endif /* CONSTANTS_hpp */
\ No newline at end of file
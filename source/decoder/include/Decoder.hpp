@@ -15,10 +15,14 @@
 #define Decoder_hpp
 
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include "../../constants/constants.hpp"
 #include "../../losslessCoding/include/SPIHT_Dec.hpp"
+#include "../../utilities/include/Parallel.hpp"
+#include "../../utilities/include/Stats.hpp"
+#include "../../utilities/include/StreamHeader.hpp"
 #include "../../utilities/include/Utilities.hpp"
 #include "../../wavelet/include/Wavelet.hpp"
 
@@ -30,30 +34,72 @@ static constexpr size_t MIN_SIZE = 8;
 class Decoder {
   public:
     Decoder(int maxChannels = MAXCHANNELS_DEFAULT);
+    // the entropy decoder keeps a pointer to the statistics of its decoder
+    Decoder(const Decoder&) = delete;
+    Decoder(Decoder&&) = delete;
+    auto operator=(const Decoder&) -> Decoder& = delete;
+    auto operator=(Decoder&&) -> Decoder& = delete;
+    ~Decoder() = default;
 
-    auto decodeMD(std::vector<char>& bitstream) -> std::vector<std::vector<double>>;
-    auto decode1D(std::vector<char>& bitstream) -> std::vector<double>;
-    void decodeBlock(std::vector<char>& bitstream, std::vector<double>& sig_dwt);
+    auto decodeMD(const BitReader& bitstream) -> std::vector<std::vector<double>>;
+    auto decode1D(const BitReader& bitstream) -> std::vector<double>;
+    auto decodeRange(const BitReader& bitstream, size_t start, size_t count) -> std::vector<std::vector<double>>;
+    void decodeBlock(BitReader& bitstream, std::vector<double>& sig_dwt);
+
+    auto truncateMD(const BitReader& bitstream, size_t block_bytes) -> BitWriter;
+    auto truncate1D(const BitReader& bitstream, size_t block_bytes) -> BitWriter;
 
     [[nodiscard]] auto getFS() const -> int;
+    void setThreads(int threads);
+
+    [[nodiscard]] auto getStats() const -> const Stats&;
+    void resetStats();
 
   protected:
-    auto losslessDecoding(std::vector<char>& bitstream, std::vector<int>& sig_intquant, double& multiplicator) -> int;
+    void decodeBlocks(BitReader& bitstream, int channels, std::vector<std::vector<double>>& sig_rec);
+    void decodeSlices(BitReader& bitstream, int channels, std::vector<std::vector<double>>& sig_rec);
+    void decodeSliceRange(const BitReader& bitstream,
+                          const SliceIndex& index,
+                          size_t first,
+                          size_t last,
+                          int channels,
+                          std::vector<std::vector<double>>& sig_rec);
+    auto truncateStream(const BitReader& bitstream, bool multichannel, size_t block_bytes) -> BitWriter;
+    void truncateBlocks(BitReader& bitstream, size_t block_bits, BitWriter& out);
+
+    auto losslessDecoding(BitReader& bitstream, std::vector<int>& sig_intquant, double& multiplicator) -> int;
 
-    static auto fsDecode(std::vector<char>& bitstream) -> int;
-    auto decodeChannels(std::vector<char>& bitstream) const -> int;
-    void headerDecoding(std::vector<char>& bitstream);
-    auto lengthDecoding(std::vector<char>& bitstream) const -> int;
+    auto streamHeaderDecoding(BitReader& bitstream) -> StreamHeader;
+    auto preambleDecoding(BitReader& bitstream, bool multichannel, ContainerInfo& info) -> StreamHeader;
+    static auto fsDecode(BitReader& bitstream) -> int;
+    auto decodeChannels(BitReader& bitstream) const -> int;
+    void headerDecoding(BitReader& bitstream);
+    auto lengthDecoding(BitReader& bitstream) const -> int;
 
     SPIHT_Dec spiht;
 
+    // per-stage timing and counters; only recorded if built with VC_PWQ_STATS
+    Stats stats;
+
     int bl = 0;
     int dwtlevel = 0;
 
+    std::vector<double> buffer;
+    std::vector<double> dwt_scratch;
+    // quantized block; sized by headerDecoding and reused, so decoding a block does not allocate
+    std::vector<int> block_intquant;
+
+    int fs = 0;
+
   private:
     int channelbits = 0;
     int lengthbits = 0;
-    int fs = 0;
+    EntropyCoder coder = EntropyCoder::ARITHMETIC;
+    bool scalable = false;
+
+    // slice mode; the decoders for additional threads are kept for the next signal
+    int threads = 1;
+    std::vector<std::unique_ptr<Decoder>> slice_workers;
 };
 
 }  // namespace VC_PWQ
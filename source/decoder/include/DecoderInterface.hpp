@@ -16,9 +16,13 @@
 
 #include <cstdio>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 
 #include <AudioFile.h>
 
+#include "../../utilities/include/MappedFile.hpp"
+#include "../../utilities/include/Parallel.hpp"
 #include "../../utilities/include/Utilities.hpp"
 #include "Decoder.hpp"
 
@@ -41,10 +45,33 @@ class DecoderInterface {
     auto decodeFile1D(const std::string& inFile, std::vector<double>& sig_rec, const std::string& outFile = "") const
         -> int;
 
+    void setThreads(int threads);
+
+    [[nodiscard]] auto getStats() const -> Stats;
+    void resetStats();
+    [[nodiscard]] auto saveStats(const std::string& filename) const -> bool;
+
   protected:
+    auto decodeFileMD(const std::string& inFile,
+                      std::vector<std::vector<double> >& sig_rec,
+                      const std::string& outFile,
+                      Decoder& decoder) const -> int;
+    auto decodeFile1D(const std::string& inFile,
+                      std::vector<double>& sig_rec,
+                      const std::string& outFile,
+                      Decoder& decoder) const -> int;
+    static auto collectFiles(const std::string& inFolder, const std::string& outFolder, const std::string& type)
+        -> std::vector<std::pair<std::string, std::string> >;
+    void recordStats(Decoder& decoder, const Stats& file_stats) const;
+
     bool txt_mode;
     int fs;
     std::string delimiter;
+    int threads = 1;
+
+    // statistics of all decoded files; only recorded if built with VC_PWQ_STATS
+    mutable Stats stats;
+    mutable std::mutex stats_mutex;
 };
 
 }  // namespace VC_PWQ
@@ -0,0 +1,70 @@
+//=======================================================================
+/** @file StreamingDecoder.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Pull-style decoder: encoded bytes are passed as they arrive and every block is decoded into a caller-provided
+ * buffer as soon as it is complete. The memory use is bounded by the undecoded input.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef StreamingDecoder_hpp
+#define StreamingDecoder_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Decoder.hpp"
+
+namespace VC_PWQ {
+
+class StreamingDecoder : protected Decoder {
+  public:
+    StreamingDecoder(bool multichannel = false, int maxChannels = MAXCHANNELS_DEFAULT);
+
+    void feed(const uint8_t* data, size_t bytes);
+    void endOfStream();
+    void reset();
+
+    auto ready() -> bool;
+    auto pull(double* out, size_t capacity) -> int;
+
+    [[nodiscard]] auto blockLength() const -> int;
+    [[nodiscard]] auto getChannels() const -> int;
+    using Decoder::getFS;
+    using Decoder::getStats;
+    using Decoder::resetStats;
+
+  private:
+    auto parsePreamble() -> bool;
+    auto scanBlocks() -> bool;
+    [[nodiscard]] auto cursor() const -> BitReader;
+
+    bool multichannel;
+
+    // buffered input; bit_pos is the first bit not decoded yet
+    std::vector<uint8_t> input;
+    size_t bit_pos = 0;
+    bool end_of_stream = false;
+
+    bool preamble_done = false;
+    int channels = 1;
+    int slice_blocks = 0;
+    int slice_rows = 0;
+
+    // seekable streams: samples per channel not pulled yet; the last block is cut to the signal length
+    bool seekable = false;
+    size_t samples_left = 0;
+
+    // block length of the blocks found by scanBlocks; 0 if no complete block is buffered
+    int next_bl = 0;
+};
+
+}  // namespace VC_PWQ
+
+#endif /* StreamingDecoder_hpp */
@@ -13,94 +13,375 @@
 
 #include "../include/Decoder.hpp"
 
+#include "../../utilities/include/Simd.hpp"
+
 namespace VC_PWQ {
 
+namespace {
+
+/**
+ * @brief copy bits from a reader to a writer
+ * @param in read cursor; advanced behind the copied bits
+ * @param length number of bits
+ * @param out bitstream to append to
+ */
+void copyBits(BitReader& in, size_t length, BitWriter& out) {
+    while (length > 0) {
+        int chunk = (int)std::min(length, (size_t)MAX_FIELD_BITS);
+        out.write(in.read(chunk), chunk);
+        length -= chunk;
+    }
+}
+
+}  // namespace
+
 /**
  * @brief constructor of the decoder
  * @param maxChannels specify maximum number of channels supported; default on 8
  */
-Decoder::Decoder(int maxChannels) : channelbits(ceil(log2(maxChannels + 1))) {}
+Decoder::Decoder(int maxChannels) : channelbits(ceil(log2(maxChannels + 1))) {
+    spiht.setStats(&stats);
+}
 
 /**
  * @brief decode multichannel signal
+ * @details the bitstream is not modified; decoding advances a separate read cursor
  * @param bitstream bitstream of encoded signal
  * @return decoded multichannel signal
  */
-auto Decoder::decodeMD(std::vector<char>& bitstream) -> std::vector<std::vector<double>> {
+auto Decoder::decodeMD(const BitReader& bitstream) -> std::vector<std::vector<double>> {
 
-    std::vector<std::vector<double>> sig_rec;
+    BitReader cursor = bitstream;
 
-    int channels = decodeChannels(bitstream);
+    ContainerInfo info;
+    StreamHeader header = preambleDecoding(cursor, true, info);
+    int channels = info.channels;
+    if (channels < 1) {
+        return {};
+    }
 
-    spiht.resetCounter();
+    std::vector<std::vector<double>> sig_rec(channels);
+    if (header.hasSlices()) {
+        decodeSlices(cursor, channels, sig_rec);
+    } else {
+        decodeBlocks(cursor, channels, sig_rec);
+    }
 
-    fs = fsDecode(bitstream);
+    if (header.isSeekable()) {
+        for (auto& sig : sig_rec) {
+            sig.resize(std::min(sig.size(), info.samples));
+        }
+    }
+    return sig_rec;
+}
 
-    for (int c = 0; c < channels; c++) {
-        std::vector<double> sig;
-        sig.reserve(MAX_BL * RESERVE_BLOCKS);
-        sig_rec.push_back(sig);
+/**
+ * @brief decode single channel signal
+ * @details the bitstream is not modified; decoding advances a separate read cursor
+ * @param bitstream bitstream of encoded signal
+ * @return decoded signal
+ */
+auto Decoder::decode1D(const BitReader& bitstream) -> std::vector<double> {
+
+    BitReader cursor = bitstream;
+    ContainerInfo info;
+    StreamHeader header = preambleDecoding(cursor, false, info);
+    if (info.channels < 1) {
+        return {};
+    }
+
+    std::vector<std::vector<double>> sig_rec(info.channels);
+    if (header.hasSlices()) {
+        decodeSlices(cursor, info.channels, sig_rec);
+    } else {
+        decodeBlocks(cursor, info.channels, sig_rec);
+    }
+
+    if (header.isSeekable()) {
+        sig_rec[0].resize(std::min(sig_rec[0].size(), info.samples));
     }
+    return std::move(sig_rec[0]);
+}
 
-    int start = 0;
-    while (bitstream.size() > MIN_SIZE) {
+/**
+ * @brief decode the samples [start, start + count) of all channels of a seekable stream
+ * @details only the slices containing the range are decoded; the slice index locates them and every slice starts with
+ * reset context counters; the range is limited to the samples of the signal
+ * @param bitstream bitstream of a seekable encoded signal
+ * @param start first sample
+ * @param count number of samples
+ * @return decoded range, one vector per channel; empty if the stream is not seekable
+ */
+auto Decoder::decodeRange(const BitReader& bitstream, size_t start, size_t count) -> std::vector<std::vector<double>> {
+
+    BitReader cursor = bitstream;
+    ContainerInfo info;
+    StreamHeader header = preambleDecoding(cursor, true, info);
+    if (!header.isSeekable()) {
+        std::cerr << "stream is not seekable" << std::endl;
+        return {};
+    }
+    if (info.channels < 1) {
+        return {};
+    }
+
+    SliceIndex index;
+    if (!readSliceIndex(cursor, index) || index.slice_blocks < 1) {
+        std::cerr << "invalid slice index" << std::endl;
+        return {};
+    }
+
+    start = std::min(start, info.samples);
+    count = std::min(count, info.samples - start);
+    std::vector<std::vector<double>> sig_rec(info.channels);
+    if (count == 0) {
+        return sig_rec;
+    }
+
+    size_t slice_samples = (size_t)index.slice_blocks * info.bl;
+    size_t first = start / slice_samples;
+    size_t last = std::min(index.offsets.size(), (start + count + slice_samples - 1) / slice_samples);
+    decodeSliceRange(cursor, index, first, last, info.channels, sig_rec);
+
+    size_t skip = start - first * slice_samples;
+    for (auto& sig : sig_rec) {
+        sig.erase(sig.begin(), sig.begin() + (long)std::min(skip, sig.size()));
+        sig.resize(count, 0);
+    }
+    return sig_rec;
+}
+
+/**
+ * @brief decode blocks until the end of the bitstream; the blocks of all channels are interleaved
+ * @param bitstream read cursor positioned at the first block
+ * @param channels number of channels
+ * @param sig_rec decoded channels; the decoded blocks are appended
+ */
+void Decoder::decodeBlocks(BitReader& bitstream, int channels, std::vector<std::vector<double>>& sig_rec) {
+
+    for (auto& sig : sig_rec) {
+        sig.reserve(sig.size() + MAX_BL * RESERVE_BLOCKS);
+    }
+
+    size_t start = sig_rec.at(0).size();
+    while (bitstream.remaining() > MIN_SIZE) {
         for (int c = 0; c < channels; c++) {
             headerDecoding(bitstream);
             sig_rec.at(c).resize(start + bl);
 
-            std::vector<double> buffer(bl, 0);
+            buffer.resize(bl);
+            dwt_scratch.resize(bl);
             decodeBlock(bitstream, buffer);
-            std::vector<double> buffer_out = inv_DWT(buffer, dwtlevel);
-            std::copy(buffer_out.begin(), buffer_out.end(), sig_rec.at(c).begin() + start);
+            {
+                StageTimer timer(stats, Stage::DWT);
+                inv_DWT_inplace(buffer.data(), bl, dwtlevel, dwt_scratch.data());
+            }
+            std::copy(buffer.begin(), buffer.begin() + bl, sig_rec.at(c).begin() + (long)start);
         }
         start += bl;
     }
+}
 
-    return sig_rec;
+/**
+ * @brief decode a signal coded in slices; the slices are distributed over the configured number of threads
+ * @param bitstream read cursor positioned at the slice index
+ * @param channels number of channels
+ * @param sig_rec decoded channels, output variable
+ */
+void Decoder::decodeSlices(BitReader& bitstream, int channels, std::vector<std::vector<double>>& sig_rec) {
+    SliceIndex index;
+    if (!readSliceIndex(bitstream, index)) {
+        std::cerr << "invalid slice index" << std::endl;
+        return;
+    }
+    decodeSliceRange(bitstream, index, 0, index.offsets.size(), channels, sig_rec);
 }
 
 /**
- * @brief decode single channel signal
- * @param bitstream bitstream of encoded signal
- * @return decoded signal
+ * @brief decode the slices [first, last); the slices are distributed over the configured number of threads
+ * @param bitstream read cursor positioned at the first slice of the stream, behind the slice index
+ * @param index slice index
+ * @param first first slice
+ * @param last slice behind the last slice
+ * @param channels number of channels
+ * @param sig_rec decoded channels, output variable
  */
-auto Decoder::decode1D(std::vector<char>& bitstream) -> std::vector<double> {
+void Decoder::decodeSliceRange(const BitReader& bitstream,
+                               const SliceIndex& index,
+                               size_t first,
+                               size_t last,
+                               int channels,
+                               std::vector<std::vector<double>>& sig_rec) {
+    size_t slices = index.offsets.size();
+    size_t data_start = bitstream.position();
+    size_t data_end = bitstream.size();
+
+    // helper decoders for the additional threads; this decoder is worker 0
+    int workers = resolveThreads(threads, last - first);
+    while ((int)slice_workers.size() < workers - 1) {
+        slice_workers.push_back(std::make_unique<Decoder>());
+    }
 
-    std::vector<double> sig_rec;
-    spiht.resetCounter();
+    std::vector<std::vector<std::vector<double>>> parts(last - first, std::vector<std::vector<double>>(channels));
+    parallelFor(last - first, threads, [&](size_t part, int worker) {
+        Decoder& decoder = (worker == 0) ? *this : *slice_workers[worker - 1];
+        size_t s = first + part;
+        size_t begin = data_start + index.offsets[s] * BYTE_SIZE;
+        size_t end = (s + 1 < slices) ? data_start + index.offsets[s + 1] * BYTE_SIZE : data_end;
+        BitReader slice = bitstream.sub(begin, end - begin);
+        decoder.spiht.setCoder(coder);
+        decoder.scalable = scalable;
+        decoder.spiht.setScalable(scalable);
+        decoder.decodeBlocks(slice, channels, parts[part]);
+    });
+    if (STATS_ENABLED) {
+        for (auto& worker : slice_workers) {
+            stats.merge(worker->stats);
+            worker->stats.reset();
+        }
+    }
 
-    fs = fsDecode(bitstream);
-    sig_rec.reserve(MAX_BL * RESERVE_BLOCKS);
-    long start = 0;
+    for (int c = 0; c < channels; c++) {
+        size_t length = 0;
+        for (const auto& part : parts) {
+            length += part[c].size();
+        }
+        sig_rec[c].clear();
+        sig_rec[c].reserve(length);
+        for (const auto& part : parts) {
+            sig_rec[c].insert(sig_rec[c].end(), part[c].begin(), part[c].end());
+        }
+    }
+}
 
-    while (bitstream.size() > MIN_SIZE) {
+/**
+ * @brief truncate the blocks of a scalable multichannel stream
+ * @details see truncateStream
+ * @param bitstream bitstream of a scalable encoded signal
+ * @param block_bytes maximum number of bytes of the coded stream of a block
+ * @return truncated bitstream; empty if the stream is not scalable
+ */
+auto Decoder::truncateMD(const BitReader& bitstream, size_t block_bytes) -> BitWriter {
+    return truncateStream(bitstream, true, block_bytes);
+}
+
+/**
+ * @brief truncate the blocks of a scalable single channel stream
+ * @details see truncateStream
+ * @param bitstream bitstream of a scalable encoded signal
+ * @param block_bytes maximum number of bytes of the coded stream of a block
+ * @return truncated bitstream; empty if the stream is not scalable
+ */
+auto Decoder::truncate1D(const BitReader& bitstream, size_t block_bytes) -> BitWriter {
+    return truncateStream(bitstream, false, block_bytes);
+}
+
+/**
+ * @brief cut the coded stream of every block behind block_bytes bytes, without decoding the blocks
+ * @details the embedded SPIHT stream of a scalable block can be cut at any byte, a shorter block is decoded with fewer
+ * bitplanes; the headers are copied and the length fields and the slice index are adapted
+ * @param bitstream bitstream of a scalable encoded signal
+ * @param multichannel true if the stream contains the channel count
+ * @param block_bytes maximum number of bytes of the coded stream of a block
+ * @return truncated bitstream; empty if the stream is not scalable
+ */
+auto Decoder::truncateStream(const BitReader& bitstream, bool multichannel, size_t block_bytes) -> BitWriter {
+    BitWriter out;
+    BitReader cursor = bitstream;
+
+    StreamHeader header;
+    readStreamHeader(cursor, header);
+    if (!header.isScalable()) {
+        std::cerr << "stream is not scalable and cannot be truncated" << std::endl;
+        return out;
+    }
+    out.reserve(bitstream.size());
+    writeStreamHeader(header, out);
+
+    if (header.isSeekable()) {
+        ContainerInfo info;
+        if (!readContainerInfo(cursor, info)) {
+            std::cerr << "invalid container info" << std::endl;
+            out.clear();
+            return out;
+        }
+        writeContainerInfo(info, out);
+    } else {
+        if (multichannel) {
+            out.write(decodeChannels(cursor), channelbits);
+        }
+        copyBits(cursor, 2, out);  // sampling frequency
+    }
+
+    size_t block_bits = block_bytes * BYTE_SIZE;
+    if (!header.hasSlices()) {
+        truncateBlocks(cursor, block_bits, out);
+        return out;
+    }
+
+    SliceIndex index;
+    if (!readSliceIndex(cursor, index)) {
+        std::cerr << "invalid slice index" << std::endl;
+        out.clear();
+        return out;
+    }
+    size_t slices = index.offsets.size();
+    size_t data_start = cursor.position();
+    std::vector<BitWriter> parts(slices);
+    SliceIndex truncated_index;
+    truncated_index.slice_blocks = index.slice_blocks;
+    size_t offset = 0;
+    for (size_t s = 0; s < slices; s++) {
+        size_t begin = data_start + index.offsets[s] * BYTE_SIZE;
+        size_t end = (s + 1 < slices) ? data_start + index.offsets[s + 1] * BYTE_SIZE : cursor.size();
+        BitReader slice = cursor.sub(begin, end - begin);
+        truncateBlocks(slice, block_bits, parts[s]);
+        alignToByte(parts[s]);
+        truncated_index.offsets.push_back(offset);
+        offset += parts[s].sizeBytes();
+    }
+    writeSliceIndex(truncated_index, out);
+    for (const auto& part : parts) {
+        out.append(part);
+    }
+    return out;
+}
+
+/**
+ * @brief copy the blocks until the end of the bitstream, the coded stream of each block cut behind block_bits bits
+ * @param bitstream read cursor positioned at the first block
+ * @param block_bits maximum number of bits of the coded stream of a block
+ * @param out bitstream to append to
+ */
+void Decoder::truncateBlocks(BitReader& bitstream, size_t block_bits, BitWriter& out) {
+    while (bitstream.remaining() > MIN_SIZE) {
+        size_t header_start = bitstream.position();
         headerDecoding(bitstream);
-        sig_rec.resize(start + bl);
-        std::vector<double> buffer(bl, 0);
-        decodeBlock(bitstream, buffer);
-        std::vector<double> buffer_out = inv_DWT(buffer, dwtlevel);
-        std::copy(buffer_out.begin(), buffer_out.end(), sig_rec.begin() + start);
-        start += bl;
+        size_t header_bits = bitstream.position() - header_start;
+        bitstream.seek(header_start);
+        copyBits(bitstream, header_bits, out);
+
+        auto segmentlength = (size_t)lengthDecoding(bitstream);
+        size_t length = std::min(segmentlength, block_bits);
+        out.write(length, lengthbits);
+        copyBits(bitstream, length, out);
+        bitstream.skip(segmentlength - length);
     }
-    return sig_rec;
 }
 
 /**
  * @brief decode a block, single channel signal
- * @param bitstream bitstream of encoded signal
+ * @param bitstream read cursor positioned at the block length field; advanced to the next block
  * @param sig_dwt decoded block in wavelet domain
  */
-void Decoder::decodeBlock(std::vector<char>& bitstream, std::vector<double>& sig_dwt) {
+void Decoder::decodeBlock(BitReader& bitstream, std::vector<double>& sig_dwt) {
     double multiplicator = 0;
 
-    std::vector<int> sig_intquant(bl, 0);
-    int content = losslessDecoding(bitstream, sig_intquant, multiplicator);
+    int content = losslessDecoding(bitstream, block_intquant, multiplicator);
 
     if (content == 1) {
-
-        for (int i = 0; i < bl; i++) {
-            sig_dwt[i] = (double)sig_intquant[i] * multiplicator;
-        }
+        StageTimer timer(stats, Stage::QUANTIZATION);
+        Simd::dequantize(block_intquant.data(), sig_dwt.data(), bl, multiplicator);
     } else {
         for (int i = 0; i < bl; i++) {
             sig_dwt[i] = 0;
@@ -110,116 +391,172 @@ void Decoder::decodeBlock(std::vector<char>& bitstream, std::vector<double>& sig
 
 /**
  * @brief lossless decoding of a block, single channel
- * @param bitstream bitstream of encoded signal
+ * @details the symbols are entropy decoded while SPIHT runs, so their decoding time is part of the SPIHT stage; blocks
+ * of scalable streams are decoded with reset context counters and may be truncated
+ * @param bitstream read cursor; advanced behind the decoded field
  * @param sig_intquant quantized block, output variable
  * @param multiplicator rescaling value, output variable
  * @return flag indicating if block contains data
  */
-auto Decoder::losslessDecoding(std::vector<char>& bitstream, std::vector<int>& sig_intquant, double& multiplicator)
-    -> int {
+auto Decoder::losslessDecoding(BitReader& bitstream, std::vector<int>& sig_intquant, double& multiplicator) -> int {
 
-    int start = 0;
     int segmentlength = lengthDecoding(bitstream);
+    stats.addBlock(lengthbits + segmentlength);
 
     if (segmentlength > 0) {
-
+        StageTimer timer(stats, Stage::SPIHT);
         double recwavmax = 0;
         int recbitmax = 0;
-        spiht.decode(bitstream, start, segmentlength, sig_intquant, bl, dwtlevel, &recwavmax, &recbitmax);
+        if (scalable) {
+            spiht.resetCounter();
+        }
+        bool complete = spiht.decode(
+            bitstream, bitstream.position(), segmentlength, sig_intquant, bl, dwtlevel, &recwavmax, &recbitmax);
         multiplicator = recwavmax / (double)(1 << recbitmax);
-        bitstream.erase(bitstream.begin(), bitstream.begin() + start + segmentlength);
-        return 1;
+        bitstream.skip(segmentlength);
+        return complete ? 1 : 0;
     }
     return 0;
 }
 
+/**
+ * @brief read the optional stream header and configure the entropy decoder accordingly; resets the context counter
+ * @param bitstream read cursor; advanced behind the header, if there is one
+ * @return stream header; the legacy format if the stream has no header
+ */
+auto Decoder::streamHeaderDecoding(BitReader& bitstream) -> StreamHeader {
+    StreamHeader header;
+    readStreamHeader(bitstream, header);
+    coder = header.entropyCoder();
+    spiht.setCoder(coder);
+    scalable = header.isScalable();
+    spiht.setScalable(scalable);
+    return header;
+}
+
+/**
+ * @brief read the stream header, the channel count and the sampling frequency; sets the sampling frequency
+ * @details seekable streams carry the container info instead of the channel count and the sampling frequency code;
+ * the channel count is only coded in multichannel streams without container info
+ * @param bitstream read cursor; advanced to the first block or the slice index
+ * @param multichannel true if the stream contains the channel count
+ * @param info container info, output variable; for streams without container info only the channel count is set
+ * @return stream header; the legacy format if the stream has no header
+ */
+auto Decoder::preambleDecoding(BitReader& bitstream, bool multichannel, ContainerInfo& info) -> StreamHeader {
+    StreamHeader header = streamHeaderDecoding(bitstream);
+    info = ContainerInfo();
+    if (header.isSeekable()) {
+        if (!readContainerInfo(bitstream, info)) {
+            std::cerr << "invalid container info" << std::endl;
+            info.channels = 0;
+        }
+        fs = info.fs;
+    } else {
+        info.channels = multichannel ? decodeChannels(bitstream) : 1;
+        fs = fsDecode(bitstream);
+    }
+    return header;
+}
+
+/**
+ * @brief set the number of threads used to decode slices
+ * @param threads number of threads; 0 selects the number of hardware threads
+ */
+void Decoder::setThreads(int threads) {
+    this->threads = threads;
+}
+
+/**
+ * @brief get the per-stage timing and counters accumulated since construction or the last resetStats
+ * @details the values are only recorded if the library is built with VC_PWQ_STATS; the statistics of the slice
+ * threads are included
+ * @return statistics
+ */
+auto Decoder::getStats() const -> const Stats& {
+    return stats;
+}
+
+/**
+ * @brief set the statistics to zero
+ */
+void Decoder::resetStats() {
+    stats.reset();
+}
+
 /**
  * @brief decode and return the sampling frequency
- * @param bitstream bitstream of encoded signal
+ * @param bitstream read cursor; advanced behind the decoded field
  * @return sampling frequency
  */
-auto Decoder::fsDecode(std::vector<char>& bitstream) -> int {
+auto Decoder::fsDecode(BitReader& bitstream) -> int {
 
     int fs = 0;
-    if (bitstream.at(0) == 0) {
-        if (bitstream.at(1) == 0) {
+    if (bitstream.readBit() == 0) {
+        if (bitstream.readBit() == 0) {
             fs = FS_0;
         } else {
             fs = FS_1;
         }
     } else {
-        if (bitstream.at(1) == 0) {
+        if (bitstream.readBit() == 0) {
             fs = FS_2;
         } else {
             fs = 0;
         }
     }
-    bitstream.erase(bitstream.begin(), bitstream.begin() + 2);
     return fs;
 }
 
 /**
  * @brief decode and return the channel count
- * @param bitstream bitstream of encoded signal
+ * @param bitstream read cursor; advanced behind the decoded field
  * @return channel count
  */
-auto Decoder::decodeChannels(std::vector<char>& bitstream) const -> int {
-    int channels = bi2de(&bitstream, channelbits, 0);
-    bitstream.erase(bitstream.begin(), bitstream.begin() + channelbits);
-    return channels;
+auto Decoder::decodeChannels(BitReader& bitstream) const -> int {
+    return (int)bitstream.read(channelbits);
 }
 
 /**
  * @brief decode the header and set variables in decoder object
- * @param bitstream bitstream of encoded signal
+ * @param bitstream read cursor; advanced behind the decoded field
  */
-void Decoder::headerDecoding(std::vector<char>& bitstream) {
+void Decoder::headerDecoding(BitReader& bitstream) {
 
     lengthbits = LENGTHBITS_4;
-    int start = 0;
-    if (bitstream.at(start) == 1) {
+    if (bitstream.readBit() == 1) {
         bl = BL_0;
-        start += 1;
         lengthbits = LENGTHBITS_0;
     } else {
-        if (bitstream.at(start + 1) == 1) {
+        if (bitstream.readBit() == 1) {
             bl = BL_1;
-            start += 2;
             lengthbits = LENGTHBITS_1;
         } else {
-            if (bitstream.at(start + 2) == 1) {
+            if (bitstream.readBit() == 1) {
                 bl = BL_2;
-                start += 3;
                 lengthbits = LENGTHBITS_2;
             } else {
-                if (bitstream.at(start + 3) == 0) {
+                if (bitstream.readBit() == 0) {
                     bl = BL_3;
-                    start += 4;
                     lengthbits = LENGTHBITS_3;
                 } else {
                     bl = BL_4;
-                    start += 4;
                 }
             }
         }
     }
 
     dwtlevel = (int)log2(bl) - 2;
-
-    bitstream.erase(bitstream.begin(), bitstream.begin() + start);
+    block_intquant.resize(bl);
 }
 
 /**
  * @brief decode and return the length of a binary encoded signal block
- * @param bitstream bitstream of encoded signal
+ * @param bitstream read cursor; advanced behind the decoded field
  * @return length of signal block
  */
-auto Decoder::lengthDecoding(std::vector<char>& bitstream) const -> int {
-
-    int segmentlength = bi2de(&bitstream, lengthbits, 0);
-    bitstream.erase(bitstream.begin(), bitstream.begin() + lengthbits);
-
-    return segmentlength;
+auto Decoder::lengthDecoding(BitReader& bitstream) const -> int {
+    return (int)bitstream.read(lengthbits);
 }
 
 /**
@@ -27,7 +27,8 @@ DecoderInterface::DecoderInterface(bool txt_mode_new, int fs_new, std::string de
 /**
  * @brief decode all signals in a folder using the single channel codec (extended to multichannel signals) and puts it
  * in defined folder
- * @details if the output folder does not exist, it is generated
+ * @details if the output folder does not exist, it is generated; the files are distributed over the configured number
+ * of threads, each thread reuses its decoder for consecutive files
  * @param inFolder folder of the encoded signals
  * @param outFolder folder of the decoded signals
  * @param maxChannels maximum channel count expected in signals
@@ -35,7 +36,6 @@ DecoderInterface::DecoderInterface(bool txt_mode_new, int fs_new, std::string de
  */
 auto DecoderInterface::decodeFolderMD(const std::string& inFolder, const std::string& outFolder, int maxChannels) const
     -> int {
-    std::string bin = ".binary";
     std::string type;
     if (txt_mode) {
         type = ".txt";
@@ -56,34 +56,33 @@ auto DecoderInterface::decodeFolderMD(const std::string& inFolder, const std::st
         create_directory(path_products);
     }
 
-    std::string prefix = outFolder + "/";  // save folder
-    for (const auto& entry : std::filesystem::directory_iterator(inFolder)) {
-        std::string filename = entry.path();
+    const auto files = collectFiles(inFolder, outFolder, type);
+    std::vector<std::unique_ptr<Decoder>> decoders(resolveThreads(threads, files.size()));
+    std::mutex print_mutex;
 
-        if (filename.find(bin) != std::string::npos) {
-            std::string productname = filename;
-            productname.erase(0, inFolder.size() + 1);  // folder
-            productname.insert(0, prefix);
-            productname.erase(productname.end() - (long)bin.size(), productname.end());
-            productname.append(type.begin(), type.end());
-            std::vector<std::vector<double>> sig_rec;
-            decodeFileMD(filename, sig_rec, productname, maxChannels);
-            std::cout << "input filename: " << filename << std::endl;
-            std::cout << "output filename: " << productname << std::endl;
+    parallelFor(files.size(), threads, [&](size_t task, int worker) {
+        const auto& [filename, productname] = files[task];
+        if (!decoders[worker]) {
+            decoders[worker] = std::make_unique<Decoder>(maxChannels);
         }
-    }
+        std::vector<std::vector<double>> sig_rec;
+        decodeFileMD(filename, sig_rec, productname, *decoders[worker]);
+        std::lock_guard<std::mutex> lock(print_mutex);
+        std::cout << "input filename: " << filename << std::endl;
+        std::cout << "output filename: " << productname << std::endl;
+    });
     return 0;
 }
 
 /**
  * @brief decode all signals in a folder using the single channel codec and puts it in defined folder
- * @details if the output folder does not exist, it is generated
+ * @details if the output folder does not exist, it is generated; the files are distributed over the configured number
+ * of threads, each thread reuses its decoder for consecutive files
  * @param inFolder folder of the encoded signals
  * @param outFolder folder of the decoded signals
  * @return status (-1 if failed, 0 if success)
  */
 auto DecoderInterface::decodeFolder1D(const std::string& inFolder, const std::string& outFolder) const -> int {
-    std::string bin = ".binary";
     std::string type;
     if (txt_mode) {
         type = ".txt";
@@ -100,8 +99,38 @@ auto DecoderInterface::decodeFolder1D(const std::string& inFolder, const std::st
         create_directory(path_products);
     }
 
+    const auto files = collectFiles(inFolder, outFolder, type);
+    std::vector<std::unique_ptr<Decoder>> decoders(resolveThreads(threads, files.size()));
+    std::mutex print_mutex;
+
+    parallelFor(files.size(), threads, [&](size_t task, int worker) {
+        const auto& [filename, productname] = files[task];
+        if (!decoders[worker]) {
+            decoders[worker] = std::make_unique<Decoder>();
+        }
+        std::vector<double> sig_rec;
+        decodeFile1D(filename, sig_rec, productname, *decoders[worker]);
+        std::lock_guard<std::mutex> lock(print_mutex);
+        std::cout << "input filename: " << filename << std::endl;
+        std::cout << "output filename: " << productname << std::endl;
+    });
+    return 0;
+}
+
+/**
+ * @brief list the encoded files in a folder together with the names of the decoded files
+ * @param inFolder folder of the encoded signals
+ * @param outFolder folder of the decoded signals
+ * @param type file extension of the decoded signals
+ * @return pairs of input and output filename
+ */
+auto DecoderInterface::collectFiles(const std::string& inFolder, const std::string& outFolder, const std::string& type)
+    -> std::vector<std::pair<std::string, std::string>> {
+    std::string bin = ".binary";
+
     std::string prefix = outFolder + "/";  // save folder
 
+    std::vector<std::pair<std::string, std::string>> files;
     for (const auto& entry : std::filesystem::directory_iterator(inFolder)) {
         std::string filename = entry.path();
 
@@ -111,13 +140,10 @@ auto DecoderInterface::decodeFolder1D(const std::string& inFolder, const std::st
             productname.insert(0, prefix);
             productname.erase(productname.end() - (long)bin.size(), productname.end());
             productname.append(type.begin(), type.end());
-            std::vector<double> sig_rec;
-            decodeFile1D(filename, sig_rec, productname);
-            std::cout << "input filename: " << filename << std::endl;
-            std::cout << "output filename: " << productname << std::endl;
+            files.emplace_back(filename, productname);
         }
     }
-    return 0;
+    return files;
 }
 
 /**
@@ -133,14 +159,37 @@ auto DecoderInterface::decodeFileMD(const std::string& inFile,
                                     std::vector<std::vector<double>>& sig_rec,
                                     const std::string& outFile,
                                     int maxChannels) const -> int {
-    std::vector<char> bitstream;
-    loadBinary(inFile, bitstream);
-
     Decoder decoder(maxChannels);
+    return decodeFileMD(inFile, sig_rec, outFile, decoder);
+}
+
+/**
+ * @brief decode specific multichannel signal with a given decoder
+ * @details the file is memory-mapped and decoded in place; as the pages of the mapping are read during decoding, the
+ * I/O stage contains only the mapping and the output file
+ * @param inFile input file name
+ * @param sig_rec decoded signal
+ * @param outFile output file name
+ * @param decoder decoder of the calling worker
+ * @return sampling frequency
+ */
+auto DecoderInterface::decodeFileMD(const std::string& inFile,
+                                    std::vector<std::vector<double>>& sig_rec,
+                                    const std::string& outFile,
+                                    Decoder& decoder) const -> int {
+    Stats file_stats;
+    MappedFile file;
+    {
+        StageTimer timer(file_stats, Stage::IO);
+        file.open(inFile);
+    }
+    const BitReader bitstream = file.reader();
+
     sig_rec = decoder.decodeMD(bitstream);
     double fs_dec = decoder.getFS();
 
     if (!(outFile.empty())) {
+        StageTimer timer(file_stats, Stage::IO);
         if (txt_mode) {
             saveMatrixScientific(sig_rec, outFile, ",");
         } else {
@@ -153,6 +202,7 @@ auto DecoderInterface::decodeFileMD(const std::string& inFile,
             out.save(outFile);
         }
     }
+    recordStats(decoder, file_stats);
 
     return fs;
 }
@@ -168,14 +218,37 @@ auto DecoderInterface::decodeFileMD(const std::string& inFile,
 auto DecoderInterface::decodeFile1D(const std::string& inFile,
                                     std::vector<double>& sig_rec,
                                     const std::string& outFile) const -> int {
-    std::vector<char> bitstream;
-    loadBinary(inFile, bitstream);
-
     Decoder decoder;
+    return decodeFile1D(inFile, sig_rec, outFile, decoder);
+}
+
+/**
+ * @brief decode specific single channel signal with a given decoder
+ * @details the file is memory-mapped and decoded in place; as the pages of the mapping are read during decoding, the
+ * I/O stage contains only the mapping and the output file
+ * @param inFile input file name
+ * @param sig_rec decoded signal
+ * @param outFile output file name
+ * @param decoder decoder of the calling worker
+ * @return sampling frequency
+ */
+auto DecoderInterface::decodeFile1D(const std::string& inFile,
+                                    std::vector<double>& sig_rec,
+                                    const std::string& outFile,
+                                    Decoder& decoder) const -> int {
+    Stats file_stats;
+    MappedFile file;
+    {
+        StageTimer timer(file_stats, Stage::IO);
+        file.open(inFile);
+    }
+    const BitReader bitstream = file.reader();
+
     sig_rec = decoder.decode1D(bitstream);
     int fs_dec = decoder.getFS();
 
     if (!(outFile.empty())) {
+        StageTimer timer(file_stats, Stage::IO);
         std::vector<std::vector<double>> buffer;
         buffer.push_back(sig_rec);
         if (txt_mode) {
@@ -190,8 +263,59 @@ auto DecoderInterface::decodeFile1D(const std::string& inFile,
             out.save(outFile);
         }
     }
+    recordStats(decoder, file_stats);
 
     return fs;
 }
 
+/**
+ * @brief set the number of threads used to decode the files of a folder
+ * @param threads number of threads; 0 selects the number of hardware threads
+ */
+void DecoderInterface::setThreads(int threads) {
+    this->threads = threads;
+}
+
+/**
+ * @brief add the statistics of a decoded file to the statistics of the interface; the decoder statistics are reset
+ * @param decoder decoder of the file
+ * @param file_stats statistics recorded by the interface, i.e. the file I/O
+ */
+void DecoderInterface::recordStats(Decoder& decoder, const Stats& file_stats) const {
+    if (!STATS_ENABLED) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats.merge(decoder.getStats());
+    stats.merge(file_stats);
+    decoder.resetStats();
+}
+
+/**
+ * @brief get the statistics of all files decoded since construction or the last resetStats
+ * @details the values are only recorded if the library is built with VC_PWQ_STATS
+ * @return statistics
+ */
+auto DecoderInterface::getStats() const -> Stats {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats;
+}
+
+/**
+ * @brief set the statistics to zero
+ */
+void DecoderInterface::resetStats() {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats.reset();
+}
+
+/**
+ * @brief write the statistics of all decoded files as JSON file
+ * @param filename output file
+ * @return false if the file could not be written
+ */
+auto DecoderInterface::saveStats(const std::string& filename) const -> bool {
+    return VC_PWQ::saveStats(getStats(), filename);
+}
+
 }  // namespace VC_PWQ
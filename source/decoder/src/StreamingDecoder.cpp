@@ -0,0 +1,234 @@
+//=======================================================================
+/** @file StreamingDecoder.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Pull-style decoder: encoded bytes are passed as they arrive and every block is decoded into a caller-provided
+ * buffer as soon as it is complete. The memory use is bounded by the undecoded input.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/StreamingDecoder.hpp"
+
+namespace VC_PWQ {
+
+/**
+ * @brief constructor of the streaming decoder
+ * @param multichannel true for streams of encodeMD, false for streams of encode1D
+ * @param maxChannels specify maximum number of channels supported; default on 8
+ */
+StreamingDecoder::StreamingDecoder(bool multichannel, int maxChannels)
+    : Decoder(maxChannels), multichannel(multichannel) {
+    input.reserve(RESERVE_BLOCKS * MAX_BL);
+}
+
+/**
+ * @brief append received bytes of the encoded stream
+ * @param data received bytes
+ * @param bytes number of bytes
+ */
+void StreamingDecoder::feed(const uint8_t* data, size_t bytes) {
+    input.insert(input.end(), data, data + bytes);
+}
+
+/**
+ * @brief signal that the stream is complete
+ * @details only needed for streams shorter than the stream header, which cannot be told apart from a stream header
+ * before the end is known
+ */
+void StreamingDecoder::endOfStream() {
+    end_of_stream = true;
+}
+
+/**
+ * @brief discard all buffered data and prepare for a new stream
+ */
+void StreamingDecoder::reset() {
+    input.clear();
+    bit_pos = 0;
+    end_of_stream = false;
+    preamble_done = false;
+    channels = 1;
+    slice_blocks = 0;
+    slice_rows = 0;
+    seekable = false;
+    samples_left = 0;
+    next_bl = 0;
+}
+
+/**
+ * @brief check if the next block (of every channel) is completely buffered
+ * @details the length field of each block is used to find its end
+ * @return true if pull will return samples
+ */
+auto StreamingDecoder::ready() -> bool {
+    if (!preamble_done && !parsePreamble()) {
+        return false;
+    }
+    return scanBlocks();
+}
+
+/**
+ * @brief decode the next block of every channel
+ * @details the samples are written interleaved; sample i of channel c is at out[i * channels + c]
+ * @param out output buffer
+ * @param capacity size of the output buffer; has to hold blockLength() * getChannels() samples
+ * @return number of samples per channel written; 0 if no complete block is buffered, -1 if the buffer is too small;
+ * the last block of a seekable stream is cut to the signal length
+ */
+auto StreamingDecoder::pull(double* out, size_t capacity) -> int {
+    if (!ready()) {
+        return 0;
+    }
+    int length = next_bl;
+    if ((size_t)length * channels > capacity) {
+        return -1;
+    }
+    if (seekable) {
+        length = (int)std::min((size_t)length, samples_left);
+        samples_left -= length;
+    }
+
+    BitReader bitstream = cursor();
+    for (int c = 0; c < channels; c++) {
+        headerDecoding(bitstream);
+        buffer.resize(bl);
+        dwt_scratch.resize(bl);
+        decodeBlock(bitstream, buffer);
+        {
+            StageTimer timer(stats, Stage::DWT);
+            inv_DWT_inplace(buffer.data(), bl, dwtlevel, dwt_scratch.data());
+        }
+        for (int i = 0; i < length; i++) {
+            out[(size_t)i * channels + c] = buffer[i];
+        }
+    }
+
+    // slices start byte-aligned with reset context counters
+    if (slice_blocks > 0 && ++slice_rows == slice_blocks) {
+        alignToByte(bitstream);
+        spiht.resetCounter();
+        slice_rows = 0;
+    }
+
+    // drop the decoded bytes; the buffer keeps its memory
+    bit_pos = bitstream.position();
+    size_t bytes = std::min(bit_pos / BYTE_SIZE, input.size());
+    input.erase(input.begin(), input.begin() + (long)bytes);
+    bit_pos -= bytes * BYTE_SIZE;
+    next_bl = 0;
+
+    return length;
+}
+
+/**
+ * @brief block length of the next block
+ * @return block length; 0 if no complete block is buffered
+ */
+auto StreamingDecoder::blockLength() const -> int {
+    return next_bl;
+}
+
+/**
+ * @brief number of channels of the stream
+ * @return number of channels; known once the first block is ready
+ */
+auto StreamingDecoder::getChannels() const -> int {
+    return channels;
+}
+
+/**
+ * @brief read stream header, channel count, sampling frequency and slice index, if they are completely buffered
+ * @return true if the preamble was read
+ */
+auto StreamingDecoder::parsePreamble() -> bool {
+    BitReader bitstream = cursor();
+    size_t available = bitstream.remaining();
+    size_t end = bitstream.size();
+
+    // a stream starting like the magic number may still turn out to have a stream header
+    int check = (int)std::min(available, (size_t)STREAM_MAGIC_BITS);
+    uint64_t mask = (check > 0) ? (~(uint64_t)0 >> (64 - check)) : 0;
+    if (available < (size_t)STREAM_HEADER_BITS && !end_of_stream && bitstream.peek(check) == (STREAM_MAGIC & mask)) {
+        return false;
+    }
+
+    StreamHeader header = streamHeaderDecoding(bitstream);
+    if (header.isSeekable()) {
+        ContainerInfo info;
+        if (!readContainerInfo(bitstream, info)) {
+            return false;
+        }
+        channels = info.channels;
+        fs = info.fs;
+        seekable = true;
+        samples_left = info.samples;
+    } else {
+        channels = multichannel ? decodeChannels(bitstream) : 1;
+        fs = fsDecode(bitstream);
+    }
+
+    slice_blocks = 0;
+    if (header.hasSlices()) {
+        slice_blocks = (int)bitstream.read(SLICE_BLOCKS_BITS);
+        auto count = (size_t)bitstream.read(SLICE_COUNT_BITS);
+        if (bitstream.position() > end) {
+            return false;
+        }
+        bitstream.skip(std::min(count, available) * SLICE_OFFSET_BITS);
+        alignToByte(bitstream);
+    }
+    if (bitstream.position() > end || channels < 1) {
+        return false;
+    }
+
+    bit_pos = bitstream.position();
+    slice_rows = 0;
+    preamble_done = true;
+    return true;
+}
+
+/**
+ * @brief check with the length fields if the next block of every channel is completely buffered
+ * @return true if the blocks are complete
+ */
+auto StreamingDecoder::scanBlocks() -> bool {
+    if (next_bl > 0) {
+        return true;
+    }
+    BitReader bitstream = cursor();
+    if (bitstream.remaining() <= MIN_SIZE) {
+        return false;
+    }
+    size_t end = bitstream.size();
+
+    int length = 0;
+    for (int c = 0; c < channels; c++) {
+        headerDecoding(bitstream);
+        auto segmentlength = (size_t)lengthDecoding(bitstream);
+        // bits behind the buffered input are read as zeros, so the fields are only valid up to this point
+        if (bitstream.position() > end || bitstream.position() + segmentlength > end) {
+            return false;
+        }
+        bitstream.skip(segmentlength);
+        length = bl;
+    }
+    next_bl = length;
+    return true;
+}
+
+/**
+ * @brief read cursor over the buffered input at the first bit not decoded yet
+ * @return read cursor
+ */
+auto StreamingDecoder::cursor() const -> BitReader {
+    BitReader bitstream(input.data(), input.size() * BYTE_SIZE);
+    bitstream.seek(bit_pos);
+    return bitstream;
+}
+
+}  // namespace VC_PWQ
@@ -0,0 +1,317 @@
+//=======================================================================
+/** @file Decoder.test.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/Decoder.hpp"
+#include "../include/StreamingDecoder.hpp"
+#include "../../encoder/include/Encoder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+
+// counting allocator: every allocation of the test binary passes through here
+std::atomic<bool> counting{false};
+std::atomic<size_t> allocations{0};
+
+auto testSignal(size_t length) -> std::vector<double> {
+    std::vector<double> sig(length);
+    for (size_t i = 0; i < length; i++) {
+        sig[i] = 0.7 * sin(0.05 * (double)i) + 0.2 * sin(0.91 * (double)i);  // NOLINT
+    }
+    return sig;
+}
+
+auto snr(const std::vector<double>& sig, const std::vector<double>& rec) -> double {
+    double signal = 0;
+    double noise = 0;
+    for (size_t i = 0; i < sig.size(); i++) {
+        signal += sig[i] * sig[i];
+        noise += (sig[i] - rec[i]) * (sig[i] - rec[i]);
+    }
+    return 10 * log10(signal / noise);  // NOLINT
+}
+
+/**
+ * @brief decode a stream with a streaming decoder, fed in chunks of irregular size
+ * @return decoded channels, the concatenated output of pull
+ */
+auto streamDecode(VC_PWQ::StreamingDecoder& decoder, const VC_PWQ::BitWriter& bitstream)
+    -> std::vector<std::vector<double>> {
+    static constexpr size_t feed_sizes[] = {1, 7, 50, 3, 200};  // NOLINT
+    std::vector<double> out(VC_PWQ::MAX_BL * VC_PWQ::MAXCHANNELS_DEFAULT);
+    std::vector<std::vector<double>> sig_rec;
+
+    auto pullAll = [&]() {
+        int length = 0;
+        while ((length = decoder.pull(out.data(), out.size())) > 0) {
+            sig_rec.resize(decoder.getChannels());
+            for (size_t c = 0; c < sig_rec.size(); c++) {
+                for (int i = 0; i < length; i++) {
+                    sig_rec[c].push_back(out[(size_t)i * sig_rec.size() + c]);
+                }
+            }
+        }
+    };
+
+    size_t fed = 0;
+    for (size_t i = 0; fed < bitstream.sizeBytes(); i++) {
+        size_t count = std::min(feed_sizes[i % 5], bitstream.sizeBytes() - fed);  // NOLINT
+        decoder.feed(bitstream.data() + fed, count);
+        fed += count;
+        pullAll();
+    }
+    decoder.endOfStream();
+    pullAll();
+    return sig_rec;
+}
+
+/**
+ * @brief count the allocations of a function
+ */
+template <typename F>
+auto countAllocations(F function) -> size_t {
+    allocations = 0;
+    counting = true;
+    function();
+    counting = false;
+    return allocations;
+}
+
+}  // namespace
+
+auto operator new(std::size_t size) -> void* {
+    if (counting) {
+        allocations++;
+    }
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+    std::free(p);
+}
+
+TEST_CASE("Scalable streams") {
+
+    static constexpr int bl = 256;
+    static constexpr int fs = 8000;
+    static constexpr int budget = 100;
+    const std::vector<double> sig = testSignal(16 * bl);  // NOLINT
+
+    SECTION("a scalable stream decodes like a regular one") {
+        for (auto coder : {VC_PWQ::EntropyCoder::ARITHMETIC, VC_PWQ::EntropyCoder::RANGE}) {
+            VC_PWQ::Encoder regular(bl, fs);
+            regular.setEntropyCoder(coder);
+            VC_PWQ::Encoder scalable(bl, fs);
+            scalable.setEntropyCoder(coder);
+            scalable.setScalable(true);
+
+            VC_PWQ::Decoder decoder;
+            const std::vector<double> expected = decoder.decode1D(VC_PWQ::BitReader(regular.encode1D(sig, budget)));
+            const std::vector<double> decoded = decoder.decode1D(VC_PWQ::BitReader(scalable.encode1D(sig, budget)));
+            CHECK(decoded == expected);
+        }
+    }
+
+    SECTION("the quality grows with the kept bytes per block") {
+        VC_PWQ::Encoder encoder(bl, fs);
+        encoder.setScalable(true);
+        encoder.setSlices(4);  // NOLINT
+        const VC_PWQ::BitWriter bitstream = encoder.encode1D(sig, budget);
+
+        VC_PWQ::Decoder decoder;
+        double previous = 0;
+        for (size_t block_bytes : {8, 16, 32, 64}) {  // NOLINT
+            const VC_PWQ::BitWriter truncated = decoder.truncate1D(VC_PWQ::BitReader(bitstream), block_bytes);
+            REQUIRE(truncated.size() > 0);
+            CHECK(truncated.size() < bitstream.size());
+            const double quality = snr(sig, decoder.decode1D(VC_PWQ::BitReader(truncated)));
+            CHECK(quality > previous);
+            previous = quality;
+        }
+    }
+
+    SECTION("regular streams are not truncated") {
+        VC_PWQ::Encoder encoder(bl, fs);
+        VC_PWQ::Decoder decoder;
+        CHECK(decoder.truncate1D(VC_PWQ::BitReader(encoder.encode1D(sig, budget)), 16).size() == 0);  // NOLINT
+    }
+}
+
+TEST_CASE("Seekable streams") {
+
+    static constexpr int bl = 256;
+    static constexpr int fs = 4000;  // not representable without container info
+    static constexpr int budget = 100;
+    const std::vector<double> sig = testSignal(20 * bl + 77);  // NOLINT
+    const std::vector<double> sig2(sig.rbegin(), sig.rend());
+
+    SECTION("a range matches the full decode") {
+        VC_PWQ::Encoder encoder(bl, fs);
+        encoder.setSeekable(true);
+        encoder.setSlices(3);  // NOLINT
+        const VC_PWQ::BitWriter encoded = encoder.encodeMD({sig, sig2}, budget);
+        const VC_PWQ::BitReader bitstream(encoded);
+
+        VC_PWQ::Decoder decoder;
+        const std::vector<std::vector<double>> full = decoder.decodeMD(bitstream);
+        REQUIRE(full.size() == 2);
+        CHECK(full[0].size() == sig.size());
+        CHECK(decoder.getFS() == fs);
+
+        for (size_t start : {0, 700, 768, 2000, 5000}) {  // NOLINT
+            const std::vector<std::vector<double>> range = decoder.decodeRange(bitstream, start, 1000);  // NOLINT
+            REQUIRE(range.size() == 2);
+            const size_t count = std::min((size_t)1000, sig.size() - start);  // NOLINT
+            REQUIRE(range[1].size() == count);
+            for (int c = 0; c < 2; c++) {
+                CHECK(std::equal(range[c].begin(), range[c].end(), full[c].begin() + (long)start));
+            }
+        }
+        CHECK(decoder.decodeRange(bitstream, sig.size(), 10)[0].empty());  // NOLINT
+    }
+
+    SECTION("single channel streams are trimmed to the signal length") {
+        VC_PWQ::Encoder encoder(bl, fs);
+        encoder.setSeekable(true);
+        VC_PWQ::Decoder decoder;
+        CHECK(decoder.decode1D(VC_PWQ::BitReader(encoder.encode1D(sig, budget))).size() == sig.size());
+    }
+
+    SECTION("regular streams are not seekable") {
+        VC_PWQ::Encoder encoder(bl, fs);
+        VC_PWQ::Decoder decoder;
+        CHECK(decoder.decodeRange(VC_PWQ::BitReader(encoder.encodeMD({sig}, budget)), 0, 10).empty());  // NOLINT
+    }
+}
+
+TEST_CASE("StreamingDecoder") {
+
+    static constexpr int bl = 256;
+    static constexpr int fs = 8000;
+    static constexpr int budget = 60;
+    const std::vector<double> sig = testSignal(10 * bl);  // NOLINT
+    const std::vector<std::vector<double>> channels = {
+        sig, std::vector<double>(sig.rbegin(), sig.rend()), std::vector<double>(sig.size())};
+
+    SECTION("chunked single channel streams match decode1D") {
+        for (auto coder : {VC_PWQ::EntropyCoder::ARITHMETIC, VC_PWQ::EntropyCoder::RANGE}) {
+            for (int slices : {0, 3}) {
+                VC_PWQ::Encoder encoder(bl, fs);
+                encoder.setEntropyCoder(coder);
+                encoder.setSlices(slices);
+                const VC_PWQ::BitWriter bitstream = encoder.encode1D(sig, budget);
+
+                VC_PWQ::Decoder reference;
+                VC_PWQ::StreamingDecoder decoder;
+                const std::vector<std::vector<double>> decoded = streamDecode(decoder, bitstream);
+                REQUIRE(decoded.size() == 1);
+                CHECK(decoded[0] == reference.decode1D(VC_PWQ::BitReader(bitstream)));
+                CHECK(decoder.getFS() == fs);
+            }
+        }
+    }
+
+    SECTION("chunked multichannel streams match decodeMD") {
+        for (auto coder : {VC_PWQ::EntropyCoder::ARITHMETIC, VC_PWQ::EntropyCoder::RANGE}) {
+            for (int slices : {0, 2}) {
+                VC_PWQ::Encoder encoder(bl, fs);
+                encoder.setEntropyCoder(coder);
+                encoder.setSlices(slices);
+                const VC_PWQ::BitWriter bitstream = encoder.encodeMD(channels, budget);
+
+                VC_PWQ::Decoder reference;
+                VC_PWQ::StreamingDecoder decoder(true);
+                CHECK(streamDecode(decoder, bitstream) == reference.decodeMD(VC_PWQ::BitReader(bitstream)));
+            }
+        }
+    }
+
+    SECTION("seekable streams are cut to the signal length") {
+        const std::vector<double> part(sig.begin(), sig.begin() + 7 * bl + 13);  // NOLINT
+        const std::vector<std::vector<double>> parts = {part, part};
+        VC_PWQ::Encoder encoder(bl, fs);
+        encoder.setSeekable(true);
+        encoder.setSlices(3);  // NOLINT
+        const VC_PWQ::BitWriter single = encoder.encode1D(part, budget);
+        const VC_PWQ::BitWriter multi = encoder.encodeMD(parts, budget);
+
+        VC_PWQ::Decoder reference;
+        VC_PWQ::StreamingDecoder decoder;
+        const std::vector<std::vector<double>> decoded = streamDecode(decoder, single);
+        REQUIRE(decoded.size() == 1);
+        CHECK(decoded[0].size() == part.size());
+        CHECK(decoded[0] == reference.decode1D(VC_PWQ::BitReader(single)));
+
+        VC_PWQ::StreamingDecoder decoderMD(true);
+        CHECK(streamDecode(decoderMD, multi) == reference.decodeMD(VC_PWQ::BitReader(multi)));
+    }
+
+    SECTION("blocks are only ready when they are complete") {
+        VC_PWQ::Encoder encoder(bl, fs);
+        encoder.setEntropyCoder(VC_PWQ::EntropyCoder::RANGE);
+        const VC_PWQ::BitWriter bitstream = encoder.encodeMD(channels, budget);
+        VC_PWQ::StreamingDecoder decoder(true);
+        std::vector<double> out((size_t)bl * channels.size());
+
+        decoder.feed(bitstream.data(), 1);
+        CHECK(!decoder.ready());
+        CHECK(decoder.pull(out.data(), out.size()) == 0);
+
+        // the first block of every channel is ready before the stream is complete
+        size_t fed = 1;
+        while (!decoder.ready()) {
+            REQUIRE(fed < bitstream.sizeBytes());
+            decoder.feed(bitstream.data() + fed, 1);
+            fed++;
+        }
+        CHECK(fed < bitstream.sizeBytes());
+        CHECK(decoder.blockLength() == bl);
+        CHECK(decoder.getChannels() == 3);
+
+        CHECK(decoder.pull(out.data(), out.size() - 1) == -1);
+        CHECK(decoder.ready());
+        CHECK(decoder.pull(out.data(), out.size()) == bl);
+    }
+
+    SECTION("steady-state pull does not allocate") {
+        for (auto coder : {VC_PWQ::EntropyCoder::ARITHMETIC, VC_PWQ::EntropyCoder::RANGE}) {
+            VC_PWQ::Encoder encoder(bl, fs);
+            encoder.setEntropyCoder(coder);
+            const VC_PWQ::BitWriter bitstream = encoder.encodeMD(channels, budget);
+            VC_PWQ::StreamingDecoder decoder(true);
+            std::vector<double> out((size_t)bl * channels.size());
+            decoder.feed(bitstream.data(), bitstream.sizeBytes());
+            REQUIRE(decoder.pull(out.data(), out.size()) == bl);  // warm-up
+
+            CHECK(countAllocations([&]() {
+                      for (int b = 0; b < 4; b++) {  // NOLINT
+                          decoder.pull(out.data(), out.size());
+                      }
+                  }) == 0);
+        }
+    }
+}
@@ -14,16 +14,22 @@
 #ifndef Encoder_hpp
 #define Encoder_hpp
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <vector>
 
 #include "../../constants/constants.hpp"
 #include "../../losslessCoding/include/ArithEnc.hpp"
 #include "../../losslessCoding/include/SPIHT_Enc.hpp"
 #include "../../psychohapticModel/include/PsychohapticModel.hpp"
+#include "../../utilities/include/Parallel.hpp"
+#include "../../utilities/include/Stats.hpp"
+#include "../../utilities/include/StreamHeader.hpp"
 #include "../../utilities/include/Utilities.hpp"
 #include "../../wavelet/include/Wavelet.hpp"
 
@@ -32,50 +38,159 @@ namespace VC_PWQ {
 static constexpr size_t MAXSTREAMLENGTH = 2 ^ 14 - 1;
 static constexpr size_t BINARY_RESERVE = 20000;
 
+// rate control, see Encoder::setRateControl
+static constexpr int RATE_LOOKAHEAD_DEFAULT = 4;
+static constexpr int RATE_RETRIES = 4;
+static constexpr double RATE_SMOOTHING = 0.25;
+static constexpr double DB_PER_BIT = 6.02;
+
+// seekable streams without explicit slices; blocks per slice, see Encoder::setSeekable
+static constexpr int SEEK_BLOCKS_DEFAULT = 16;
+
 class Encoder {
   public:
-    Encoder(int bl_new, int fs_new, int maxChannels = MAXCHANNELS_DEFAULT);
+    Encoder(int bl_new,
+            int fs_new,
+            int maxChannels = MAXCHANNELS_DEFAULT,
+            PlanningMode planning = PlanningMode::ESTIMATE);
+    // the entropy coder keeps a pointer to the statistics of its encoder
+    Encoder(const Encoder&) = delete;
+    Encoder(Encoder&&) = delete;
+    auto operator=(const Encoder&) -> Encoder& = delete;
+    auto operator=(Encoder&&) -> Encoder& = delete;
+    ~Encoder() = default;
+
+    auto encodeMD(const std::vector<std::vector<double>>& sig, int bitbudget) -> BitWriter;
+    auto encodeMD(const double* interleaved, size_t frames, int channels, int bitbudget) -> BitWriter;
+    auto encodeMD(const std::vector<ChannelView>& sig, int bitbudget) -> BitWriter;
+    auto encode1D(const std::vector<double>& sig, int bitbudget) -> BitWriter;
+
+    void setEntropyCoder(EntropyCoder coder);
+    void setSlices(int slice_blocks);
+    void setThreads(int threads);
+    void setRateControl(double kbps, int buffer_bits, int lookahead = RATE_LOOKAHEAD_DEFAULT);
+    void setScalable(bool scalable);
+    void setSeekable(bool seekable);
 
-    auto encodeMD(std::vector<std::vector<double>>& sig, int bitbudget) -> std::vector<char>;
-    auto encode1D(std::vector<double>& sig, int bitbudget) -> std::vector<char>;
+    [[nodiscard]] auto getStats() const -> const Stats&;
+    void resetStats();
 
   protected:
+    using SliceFunction = std::function<void(Encoder& encoder, size_t first, size_t last, BitWriter& bitstream)>;
+
+    void encodeBlocksMD(
+        const std::vector<ChannelView>& sig, size_t first, size_t last, int bitbudget, BitWriter& bitstream);
+    void encodeBlocks1D(const ChannelView& sig, size_t first, size_t last, int bitbudget, BitWriter& bitstream);
+    void encodeBlocksRate(
+        const std::vector<ChannelView>& sig, size_t first, size_t last, int bitbudget, BitWriter& bitstream);
+    void encodeSlices(size_t numblocks, const SliceFunction& encodeRange, BitWriter& bitstream);
+    void reserveChannels(int channels);
+    void startRateControl(int channels);
+    void analyzeBlockRate(const std::vector<ChannelView>& sig, size_t block);
+    void encodeBlockRate(std::vector<double>& block_dwt,
+                         const std::vector<double>& SMR,
+                         const std::vector<double>& bandenergy,
+                         double weight,
+                         BitWriter& bitstream,
+                         int bitbudget);
+    auto perceptualDemand(const std::vector<double>& SMR) const -> double;
+
     auto encodeBlock(std::vector<double>& block_dwt,
-                     std::vector<double> SMR,
-                     std::vector<double> bandenergy,
-                     std::vector<char>& bitstream,
-                     int bitbudget) -> std::vector<double>;
-
-    void losslessEncoding(std::vector<int>& block_intquant,
-                          std::vector<char>& bitwavmax,
-                          int bitmax,
-                          std::vector<char>& bitstream);
-
-    void fsEncode(std::vector<char>* bitstream) const;
-    auto encodeChannels(int channels, std::vector<char>* bitstream) const -> int;
-    void headerEncoding(std::vector<char>* bitstream) const;
-    void lengthEncoding(std::vector<char>& outstream, std::vector<char>& blockstream) const;
-    void static maximumWaveletCoefficient(std::vector<double>& sig, double* qwavmax, std::vector<char>* bitwavmax);
-    void updateNoise(std::vector<double>& bandenergy,
-                     std::vector<double>& noiseenergy,
-                     std::vector<double>& SNR,
+                     const std::vector<double>& SMR,
+                     const std::vector<double>& bandenergy,
+                     BitWriter& bitstream,
+                     int bitbudget) -> const std::vector<double>&;
+    void allocateBits(std::vector<double>& block_dwt,
+                      double qwavmax,
+                      const std::vector<double>& SMR,
+                      const std::vector<double>& bandenergy,
+                      int bitbudget,
+                      std::vector<int>& bitalloc,
+                      std::vector<int>& quantbits);
+    auto bandNoise(std::vector<double>& block_dwt, int band, double max, int bits) const -> double;
+
+    void losslessEncoding(std::vector<int>& block_intquant, BitWriter& bitwavmax, int bitmax, BitWriter& bitstream);
+
+    void streamHeaderEncoding(BitWriter* bitstream) const;
+    auto containerEncoding(int channels, size_t samples, BitWriter* bitstream) const -> int;
+    [[nodiscard]] auto sliceBlocks() const -> int;
+    void fsEncode(BitWriter* bitstream) const;
+    auto encodeChannels(int channels, BitWriter* bitstream) const -> int;
+    void headerEncoding(BitWriter* bitstream) const;
+    void lengthEncoding(BitWriter& outstream, BitWriter& blockstream) const;
+    void static maximumWaveletCoefficient(std::vector<double>& sig, double* qwavmax, BitWriter* bitwavmax);
+    void updateNoise(int band,
+                     double noiseenergy,
+                     const std::vector<double>& bandenergy,
+                     const std::vector<double>& SMR,
                      std::vector<double>& MNR,
-                     std::vector<double>& SMR) const;
+                     const std::vector<int>& bitalloc) const;
 
     SPIHT_Enc spiht;
     ArithEnc arithmetic;
     PsychohapticModel pm;
 
+    // per-stage timing and counters; only recorded if built with VC_PWQ_STATS
+    Stats stats;
+
     std::vector<int> book;
     std::vector<int> book_cumulative;
     int l_book;
     int bl;
     int dwtlevel;
 
+    // per-block scratch; sized in the constructor and reused, so encoding a block does not allocate
+    std::vector<double> block_sign;
+    std::vector<double> block_mag;
+    std::vector<double> dwt_scratch;
+    std::vector<double> block_in;
+    std::vector<double> block_dwt_quant;
+    std::vector<int> block_intquant;
+    std::vector<int> block_bitalloc;
+    std::vector<int> block_quantbits;
+    std::vector<double> block_MNR;
+    std::vector<double> block_SMR;
+    std::vector<double> block_bandenergy;
+    BitWriter block_bitwavmax;
+    BitWriter arithmetic_stream;
+
+    // multichannel scratch, see reserveChannels
+    std::vector<double> blocksMD;
+    std::vector<std::vector<double>> waveletsMD;
+    std::vector<std::vector<double>> SMR_MD;
+    std::vector<std::vector<double>> bandenergy_MD;
+
+    // rate control lookahead; ring of analyzed blocks, slot (block % window) * channels + channel
+    std::vector<std::vector<double>> rate_wavelets;
+    std::vector<std::vector<double>> rate_SMR;
+    std::vector<std::vector<double>> rate_bandenergy;
+    std::vector<double> rate_demand;
+
   private:
     int channelbits;
     int fs;
     int lengthbits;
+    EntropyCoder coder = EntropyCoder::ARITHMETIC;
+    bool scalable = false;
+    bool seekable = false;
+    int maxChannels;
+    PlanningMode planning;
+
+    // slice mode; the encoders for additional threads are kept for the next signal
+    int slice_blocks = 0;
+    int threads = 1;
+    std::vector<std::unique_ptr<Encoder>> slice_workers;
+    std::vector<BitWriter> slice_streams;
+
+    // rate control; the bucket is filled with the coded blocks and drained with the target rate
+    double rate_kbps = 0;
+    int rate_buffer = 0;
+    int rate_lookahead = RATE_LOOKAHEAD_DEFAULT;
+    double rate_drain = 0;
+    double rate_fullness = 0;
+    double rate_bits_per_budget = 0;
+    int rate_overhead = 0;
+    int rate_channels = 1;
 };
 
 }  // namespace VC_PWQ
@@ -15,9 +15,12 @@
 #define EncoderInterface_hpp
 
 #include <filesystem>
+#include <memory>
+#include <mutex>
 
 #include <AudioFile.h>
 
+#include "../../utilities/include/Parallel.hpp"
 #include "Encoder.hpp"
 
 namespace VC_PWQ {
@@ -26,7 +29,7 @@ static constexpr size_t BUFFERSIZE_INTERFACE = 10000;
 
 class EncoderInterface {
   public:
-    EncoderInterface(int fs = 0);
+    EncoderInterface(int fs = 0, PlanningMode planning = PlanningMode::ESTIMATE);
 
     auto encodeFolderMD(const std::string& inFolder,
                         const std::string& outFolder,
@@ -46,8 +49,56 @@ class EncoderInterface {
                       int maxChannels = MAXCHANNELS_DEFAULT) const -> int;
     auto encodeFile1D(const std::string& inFile, const std::string& outFile, int bl, int bitbudget) const -> int;
 
+    void setEntropyCoder(EntropyCoder coder);
+    void setThreads(int threads);
+    void setSlices(int slice_blocks);
+    void setRateControl(double kbps, int buffer_bits, int lookahead = RATE_LOOKAHEAD_DEFAULT);
+    void setScalable(bool scalable);
+    void setSeekable(bool seekable);
+
+    [[nodiscard]] auto getStats() const -> Stats;
+    void resetStats();
+    [[nodiscard]] auto saveStats(const std::string& filename) const -> bool;
+
   protected:
+    // encoder reused for consecutive files of a worker; recreated if the settings change
+    struct EncoderSlot {
+        std::unique_ptr<Encoder> encoder;
+        int bl = 0;
+        int fs = 0;
+        int maxChannels = 0;
+    };
+
+    auto getEncoder(EncoderSlot& slot, int bl, int fs, int maxChannels) const -> Encoder&;
+    auto encodeFileMD(const std::string& inFile,
+                      const std::string& outFile,
+                      int bl,
+                      int bitbudget,
+                      int maxChannels,
+                      EncoderSlot& slot) const -> int;
+    auto encodeFile1D(const std::string& inFile,
+                      const std::string& outFile,
+                      int bl,
+                      int bitbudget,
+                      EncoderSlot& slot) const -> int;
+    static auto collectFiles(const std::string& inFolder, const std::string& outFolder, const std::string& appendix)
+        -> std::vector<std::pair<std::string, std::string>>;
+    void recordStats(Encoder& encoder, const Stats& file_stats) const;
+
     int fs;
+    PlanningMode planning;
+    EntropyCoder coder = EntropyCoder::ARITHMETIC;
+    int threads = 1;
+    int slice_blocks = 0;
+    bool scalable = false;
+    bool seekable = false;
+    double rate_kbps = 0;
+    int rate_buffer = 0;
+    int rate_lookahead = RATE_LOOKAHEAD_DEFAULT;
+
+    // statistics of all encoded files; only recorded if built with VC_PWQ_STATS
+    mutable Stats stats;
+    mutable std::mutex stats_mutex;
 };
 
 }  // namespace VC_PWQ
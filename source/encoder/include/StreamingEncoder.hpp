@@ -0,0 +1,66 @@
+//=======================================================================
+/** @file StreamingEncoder.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Push-style encoder for real-time capture: samples are passed in chunks of arbitrary size, every block is encoded as
+ * soon as it is complete and its bytes can be read right away. The latency is bounded to one block.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef StreamingEncoder_hpp
+#define StreamingEncoder_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Encoder.hpp"
+
+namespace VC_PWQ {
+
+static constexpr size_t STREAMING_RESERVE_BLOCKS = 4;
+
+class StreamingEncoder : protected Encoder {
+  public:
+    StreamingEncoder(int bl_new,
+                     int fs_new,
+                     int bitbudget,
+                     int channels = 1,
+                     int maxChannels = MAXCHANNELS_DEFAULT,
+                     PlanningMode planning = PlanningMode::ESTIMATE);
+
+    using Encoder::setEntropyCoder;
+    using Encoder::setScalable;
+    using Encoder::getStats;
+    using Encoder::resetStats;
+
+    auto push(const double* samples, size_t frames) -> int;
+    void finish();
+
+    [[nodiscard]] auto available() const -> size_t;
+    auto read(uint8_t* dest, size_t max) -> size_t;
+
+  private:
+    void startStream();
+    void encodePending();
+
+    int channels;
+    int bitbudget;
+    bool started = false;
+    int status = 0;
+
+    // samples of the current block, one block per channel
+    std::vector<std::vector<double>> pending;
+    size_t filled = 0;
+
+    BitWriter output;
+};
+
+}  // namespace VC_PWQ
+
+#endif /* StreamingEncoder_hpp */
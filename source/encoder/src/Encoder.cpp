@@ -20,9 +20,14 @@ namespace VC_PWQ {
  * @param bl_new block length
  * @param fs_new sampling frequency; only a fixed number of values supported
  * @param maxChannels specify maximum number of channels supported; default on 8
+ * @param planning FFTW planning effort for the psychohaptic model
  */
-Encoder::Encoder(int bl_new, int fs_new, int maxChannels)
-    : bl(bl_new), fs(fs_new), channelbits(ceil(log2(maxChannels + 1))) {
+Encoder::Encoder(int bl_new, int fs_new, int maxChannels, PlanningMode planning)
+    : bl(bl_new),
+      fs(fs_new),
+      channelbits(ceil(log2(maxChannels + 1))),
+      maxChannels(maxChannels),
+      planning(planning) {
 
     switch (bl) {
         case BL_4:
@@ -60,67 +65,181 @@ Encoder::Encoder(int bl_new, int fs_new, int maxChannels)
         book_cumulative[i + 1] = book_cumulative[i] << 1;
     }
 
-    pm.init(bl, fs);
+    block_sign.resize(bl);
+    block_mag.resize(bl);
+    dwt_scratch.resize(bl);
+    block_in.resize(bl);
+    block_dwt_quant.resize(bl);
+    block_intquant.resize(bl);
+    block_bitalloc.resize(l_book);
+    block_quantbits.resize(l_book);
+    block_MNR.resize(l_book);
+    block_SMR.resize(l_book);
+    block_bandenergy.resize(l_book);
+
+    pm.init(bl, fs, planning);
+    arithmetic.setStats(&stats);
 }
 
 /**
  * @brief encode a signal with multiple channels using the VC-PWQ for each channel individually
- * @details the signal will be padded to full blocks of length bl and if the bitstream is not empty, the generated bits
- * will be appended
- * @param sig input signal
+ * @details the signal will be padded to full blocks of length bl
+ * @param sig input signal, one vector per channel
+ * @param bitbudget    limit for bitallocation
+ * @return encoded bitstream
+ */
+auto Encoder::encodeMD(const std::vector<std::vector<double>>& sig, int bitbudget) -> BitWriter {
+    std::vector<ChannelView> views;
+    views.reserve(sig.size());
+    for (const auto& s : sig) {
+        views.push_back({s.data(), s.size(), 1});
+    }
+    return encodeMD(views, bitbudget);
+}
+
+/**
+ * @brief encode an interleaved signal with multiple channels using the VC-PWQ for each channel individually
+ * @details the signal will be padded to full blocks of length bl
+ * @param interleaved input samples; sample i of channel c is at interleaved[i * channels + c]
+ * @param frames number of samples per channel
+ * @param channels number of channels
+ * @param bitbudget    limit for bitallocation
+ * @return encoded bitstream
+ */
+auto Encoder::encodeMD(const double* interleaved, size_t frames, int channels, int bitbudget) -> BitWriter {
+    std::vector<ChannelView> views;
+    views.reserve(channels);
+    for (int c = 0; c < channels; c++) {
+        views.push_back({interleaved + c, frames, (size_t)channels});
+    }
+    return encodeMD(views, bitbudget);
+}
+
+/**
+ * @brief encode a signal with multiple channels using the VC-PWQ for each channel individually
+ * @details the signal will be padded to full blocks of length bl; the block length is defined by the first channel,
+ * block windows are read from the views without copying the channels
+ * @param sig views of the input channels
  * @param bitbudget    limit for bitallocation
  * @return encoded bitstream
  */
-auto Encoder::encodeMD(std::vector<std::vector<double>>& sig, int bitbudget) -> std::vector<char> {
+auto Encoder::encodeMD(const std::vector<ChannelView>& sig, int bitbudget) -> BitWriter {
 
     if (bitbudget > MAX_BITS * l_book) {
         std::cerr << "bit budget too high, switching to maximum" << std::endl;
         bitbudget = MAX_BITS * l_book;
     }
-    std::vector<char> bitstream;
+    BitWriter bitstream;
 
     int channels = (int)sig.size();
     arithmetic.resetCounter();
 
-    std::vector<double> temp = sig.at(0);
-    size_t length = temp.size();
+    size_t length = sig.at(0).length;
     auto numblocks = (size_t)ceil((double)length / (double)bl);
     bitstream.reserve(BINARY_RESERVE * numblocks * channels);
 
-    size_t diff = (numblocks * bl) - length;
-    if (diff > 0) {
-        for (int c = 0; c < channels; c++) {
-            sig.at(c).resize(((size_t)numblocks * (size_t)bl), 0);
+    streamHeaderEncoding(&bitstream);
+
+    if (seekable) {
+        if (containerEncoding(channels, length, &bitstream) == -1) {
+            bitstream.clear();
+            return bitstream;
+        }
+    } else {
+        if (encodeChannels(channels, &bitstream) == -1) {
+            bitstream.clear();
+            return bitstream;
         }
+        fsEncode(&bitstream);
     }
+    startRateControl(channels);
+
+    if (sliceBlocks() > 0) {
+        encodeSlices(
+            numblocks,
+            [&](Encoder& encoder, size_t first, size_t last, BitWriter& out) {
+                encoder.encodeBlocksMD(sig, first, last, bitbudget, out);
+            },
+            bitstream);
+    } else {
+        encodeBlocksMD(sig, 0, numblocks, bitbudget, bitstream);
+    }
+    return bitstream;
+}
 
-    if (encodeChannels(channels, &bitstream) == -1) {
-        return bitstream;
+/**
+ * @brief encode an signal with a single channel using the VC-PWQ
+ * @details the signal will be padded to full blocks of length bl
+ * @param sig input signal
+ * @param bitbudget    limit for bitallocation
+ * @return encoded bitstream
+ */
+auto Encoder::encode1D(const std::vector<double>& sig, int bitbudget) -> BitWriter {
+
+    if (bitbudget > MAX_BITS * l_book) {
+        std::cerr << "bit budget too high, switching to maximum" << std::endl;
+        bitbudget = MAX_BITS * l_book;
     }
 
-    fsEncode(&bitstream);
-    for (size_t b = 0; b < numblocks; b++) {
+    BitWriter bitstream;
 
-        std::vector<std::vector<double>> waveletsMD;
-        waveletsMD.reserve(channels);
-        std::vector<std::vector<double>> SMR_MD;
-        SMR_MD.reserve(channels);
-        std::vector<std::vector<double>> bandenergy_MD;
-        bandenergy_MD.reserve(channels);
-        // std::vector<double*> t;
-        // t.reserve(channels);
-        for (int c = 0; c < channels; c++) {
-            temp = sig.at(c);
-            // t.push_back(temp->data() + (b * bl));
+    arithmetic.resetCounter();
+
+    streamHeaderEncoding(&bitstream);
+    if (seekable) {
+        containerEncoding(1, sig.size(), &bitstream);
+    } else {
+        fsEncode(&bitstream);
+    }
 
-            std::vector<double> buffer_in(bl, 0);
-            std::copy(temp.begin() + (long)(b * bl), temp.begin() + (long)(b + 1) * bl, buffer_in.begin());
-            std::vector<double> buffer_out = DWT(buffer_in, dwtlevel);
-            waveletsMD.push_back(buffer_out);
+    ChannelView view = {sig.data(), sig.size(), 1};
+    auto numblocks = (size_t)ceil((double)view.length / (double)bl);
+    bitstream.reserve(numblocks * BINARY_RESERVE);
+    startRateControl(1);
+
+    if (sliceBlocks() > 0) {
+        encodeSlices(
+            numblocks,
+            [&](Encoder& encoder, size_t first, size_t last, BitWriter& out) {
+                encoder.encodeBlocks1D(view, first, last, bitbudget, out);
+            },
+            bitstream);
+    } else {
+        encodeBlocks1D(view, 0, numblocks, bitbudget, bitstream);
+    }
 
-            pmResult pmres = pm.getSMR(buffer_in);
-            SMR_MD.push_back(pmres.SMR);
-            bandenergy_MD.push_back(pmres.bandenergy);
+    return bitstream;
+}
+
+/**
+ * @brief encode the blocks [first, last) of a multichannel signal; the blocks of all channels are interleaved
+ * @details with rate control, the blocks are encoded by encodeBlocksRate
+ * @param sig views of the input channels
+ * @param first first block
+ * @param last block behind the last block
+ * @param bitbudget limit for bitallocation
+ * @param bitstream bitstream to append to
+ */
+void Encoder::encodeBlocksMD(
+    const std::vector<ChannelView>& sig, size_t first, size_t last, int bitbudget, BitWriter& bitstream) {
+    if (rate_kbps > 0) {
+        encodeBlocksRate(sig, first, last, bitbudget, bitstream);
+        return;
+    }
+    int channels = (int)sig.size();
+    reserveChannels(channels);
+
+    for (size_t b = first; b < last; b++) {
+        for (int c = 0; c < channels; c++) {
+            copyBlock(sig[c], b * bl, block_in);
+            std::copy(block_in.begin(), block_in.end(), blocksMD.begin() + (long)c * bl);
+            std::copy(block_in.begin(), block_in.end(), waveletsMD[c].begin());
+            StageTimer timer(stats, Stage::DWT);
+            DWT_inplace(waveletsMD[c].data(), bl, dwtlevel, dwt_scratch.data());
+        }
+        {
+            StageTimer timer(stats, Stage::PSYCHOHAPTIC_MODEL);
+            pm.getSMR_Batch(blocksMD, channels, SMR_MD, bandenergy_MD);
         }
 
         for (int c = 0; c < channels; c++) {
@@ -128,50 +247,381 @@ auto Encoder::encodeMD(std::vector<std::vector<double>>& sig, int bitbudget) ->
             encodeBlock(waveletsMD[c], SMR_MD[c], bandenergy_MD[c], bitstream, bitbudget);
         }
     }
-    return bitstream;
 }
 
 /**
- * @brief encode an signal with a single channel using the VC-PWQ
- * @details the signal will be padded to full blocks of length bl and if the bitstream is not empty, the generated bits
- * will be appended
- * @param sig input signal
- * @param bitbudget    limit for bitallocation
- * @return encoded bitstream
+ * @brief encode the blocks [first, last) of a single channel signal
+ * @details with rate control, the blocks are encoded by encodeBlocksRate
+ * @param sig view of the input signal
+ * @param first first block
+ * @param last block behind the last block
+ * @param bitbudget limit for bitallocation
+ * @param bitstream bitstream to append to
  */
-auto Encoder::encode1D(std::vector<double>& sig, int bitbudget) -> std::vector<char> {
+void Encoder::encodeBlocks1D(const ChannelView& sig, size_t first, size_t last, int bitbudget, BitWriter& bitstream) {
+    if (rate_kbps > 0) {
+        encodeBlocksRate({sig}, first, last, bitbudget, bitstream);
+        return;
+    }
+    for (size_t b = first; b < last; b++) {
+        headerEncoding(&bitstream);
 
-    if (bitbudget > MAX_BITS * l_book) {
-        std::cerr << "bit budget too high, switching to maximum" << std::endl;
-        bitbudget = MAX_BITS * l_book;
+        copyBlock(sig, b * bl, block_in);
+        {
+            StageTimer timer(stats, Stage::PSYCHOHAPTIC_MODEL);
+            pm.getSMR(block_in, block_SMR, block_bandenergy);
+        }
+        {
+            StageTimer timer(stats, Stage::DWT);
+            DWT_inplace(block_in.data(), bl, dwtlevel, dwt_scratch.data());
+        }
+        encodeBlock(block_in, block_SMR, block_bandenergy, bitstream, bitbudget);
     }
+}
 
-    std::vector<char> bitstream;
+/**
+ * @brief encode the blocks [first, last) with rate control; the blocks of all channels are interleaved
+ * @details the blocks are analyzed up to rate_lookahead blocks ahead of the encoded one, so the target size of a block
+ * can follow its perceptual demand relative to the following blocks; the stream format is the same as without rate
+ * control
+ * @param sig views of the input channels
+ * @param first first block
+ * @param last block behind the last block
+ * @param bitbudget upper limit for the bitallocation of a block
+ * @param bitstream bitstream to append to
+ */
+void Encoder::encodeBlocksRate(
+    const std::vector<ChannelView>& sig, size_t first, size_t last, int bitbudget, BitWriter& bitstream) {
+    int channels = (int)sig.size();
+    size_t window = rate_lookahead + 1;
 
-    arithmetic.resetCounter();
+    size_t analyzed = first;
+    for (size_t b = first; b < last; b++) {
+        while (analyzed < std::min(last, b + window)) {
+            analyzeBlockRate(sig, analyzed);
+            analyzed++;
+        }
 
-    fsEncode(&bitstream);
+        double demand_sum = 0;
+        for (size_t i = b; i < analyzed; i++) {
+            for (int c = 0; c < channels; c++) {
+                demand_sum += rate_demand[(i % window) * channels + c];
+            }
+        }
+        double demand_mean = demand_sum / (double)((analyzed - b) * channels);
 
-    size_t length = sig.size();
-    auto numblocks = (size_t)ceil((double)length / (double)bl);
-    bitstream.reserve(numblocks * BINARY_RESERVE);
+        for (int c = 0; c < channels; c++) {
+            size_t slot = (b % window) * channels + c;
+            double weight = (rate_demand[slot] + 1) / (demand_mean + 1);
+            encodeBlockRate(rate_wavelets[slot], rate_SMR[slot], rate_bandenergy[slot], weight, bitstream, bitbudget);
+        }
+    }
+}
 
-    size_t diff = (numblocks * bl) - length;
-    if (diff > 0) {
-        sig.resize((numblocks * bl), 0);
+/**
+ * @brief provide the multichannel scratch for a number of channels; memory is only allocated if the channel count
+ * exceeds all previous ones
+ * @param channels number of channels
+ */
+void Encoder::reserveChannels(int channels) {
+    if ((int)waveletsMD.size() >= channels) {
+        return;
     }
-    for (size_t b = 0; b < numblocks; b++) {
+    blocksMD.resize((size_t)channels * bl, 0);
+    waveletsMD.resize(channels, std::vector<double>(bl, 0));
+    SMR_MD.resize(channels, std::vector<double>(l_book, 0));
+    bandenergy_MD.resize(channels, std::vector<double>(l_book, 0));
+}
+
+/**
+ * @brief reset the leaky bucket of the rate control at the start of a signal
+ * @details the bucket starts empty and is drained by the share of one channel block of the target rate; the drain is
+ * at least the size of a block without content, which is the smallest block the encoder can write
+ * @param channels number of channels of the signal
+ */
+void Encoder::startRateControl(int channels) {
+    if (rate_kbps <= 0) {
+        return;
+    }
+    if (fs <= 0) {
+        std::cerr << "rate control needs the sampling frequency, disabling rate control" << std::endl;
+        rate_kbps = 0;
+        return;
+    }
+
+    BitWriter header;
+    headerEncoding(&header);
+    rate_overhead = (int)header.size() + lengthbits;
+
+    rate_channels = channels;
+    rate_drain = rate_kbps * 1000 * bl / fs / channels;  // NOLINT
+    if (rate_drain < rate_overhead) {
+        std::cerr << "target rate too low, switching to minimum" << std::endl;
+        rate_drain = rate_overhead;
+    }
+    rate_fullness = 0;
+    rate_bits_per_budget = (double)bl / l_book / 2;
+
+    size_t slots = (size_t)(rate_lookahead + 1) * channels;
+    if (rate_wavelets.size() < slots) {
+        rate_wavelets.resize(slots, std::vector<double>(bl, 0));
+        rate_SMR.resize(slots, std::vector<double>(l_book, 0));
+        rate_bandenergy.resize(slots, std::vector<double>(l_book, 0));
+        rate_demand.resize(slots, 0);
+    }
+    reserveChannels(channels);
+}
+
+/**
+ * @brief run the psychohaptic model and the DWT on a block of all channels and store it in the lookahead ring
+ * @param sig views of the input channels
+ * @param block index of the block
+ */
+void Encoder::analyzeBlockRate(const std::vector<ChannelView>& sig, size_t block) {
+    int channels = (int)sig.size();
+    size_t slot = (block % (rate_lookahead + 1)) * channels;
+
+    if (channels == 1) {
+        copyBlock(sig[0], block * bl, rate_wavelets[slot]);
+        {
+            StageTimer timer(stats, Stage::PSYCHOHAPTIC_MODEL);
+            pm.getSMR(rate_wavelets[slot], rate_SMR[slot], rate_bandenergy[slot]);
+        }
+        StageTimer timer(stats, Stage::DWT);
+        DWT_inplace(rate_wavelets[slot].data(), bl, dwtlevel, dwt_scratch.data());
+    } else {
+        for (int c = 0; c < channels; c++) {
+            std::vector<double>& wavelets = rate_wavelets[slot + c];
+            copyBlock(sig[c], block * bl, wavelets);
+            std::copy(wavelets.begin(), wavelets.end(), blocksMD.begin() + (long)c * bl);
+            StageTimer timer(stats, Stage::DWT);
+            DWT_inplace(wavelets.data(), bl, dwtlevel, dwt_scratch.data());
+        }
+        StageTimer timer(stats, Stage::PSYCHOHAPTIC_MODEL);
+        pm.getSMR_Batch(blocksMD, channels, SMR_MD, bandenergy_MD);
+        for (int c = 0; c < channels; c++) {
+            std::copy(SMR_MD[c].begin(), SMR_MD[c].end(), rate_SMR[slot + c].begin());
+            std::copy(bandenergy_MD[c].begin(), bandenergy_MD[c].end(), rate_bandenergy[slot + c].begin());
+        }
+    }
+
+    for (int c = 0; c < channels; c++) {
+        rate_demand[slot + c] = perceptualDemand(rate_SMR[slot + c]);
+    }
+}
+
+/**
+ * @brief encode a block with rate control, including its block length header
+ * @details the target size is the drain of the bucket scaled by the weight of the block, corrected towards a half full
+ * bucket over the lookahead window; the bit budget for the target is predicted from the coded sizes of the previous
+ * blocks. If the coded block would overflow the bucket (or the length field), it is encoded again with a lower budget;
+ * after RATE_RETRIES attempts, it is written without content.
+ * @param block_dwt wavelet coefficients of the block
+ * @param SMR signal-to-mask ratio
+ * @param bandenergy bandenergy
+ * @param weight perceptual demand of the block relative to the mean of the lookahead window
+ * @param bitstream bitstream to write to
+ * @param bitbudget upper limit for the bitallocation
+ */
+void Encoder::encodeBlockRate(std::vector<double>& block_dwt,
+                              const std::vector<double>& SMR,
+                              const std::vector<double>& bandenergy,
+                              double weight,
+                              BitWriter& bitstream,
+                              int bitbudget) {
+    double window = (double)(rate_lookahead + 1) * rate_channels;
+    double allowance = std::min((double)rate_buffer - rate_fullness + rate_drain,
+                                (double)rate_overhead + pow(2, lengthbits) - 1);
+    double target = rate_drain * weight + ((double)rate_buffer / 2 - rate_fullness) / window;
+    target = std::clamp(target, (double)rate_overhead, allowance);
+    int budget = std::clamp((int)lround((target - rate_overhead) / rate_bits_per_budget), 1, std::max(bitbudget, 1));
+
+    size_t mark = bitstream.size();
+    ArithEnc saved = arithmetic;
+    uint64_t saved_blocks = stats.blocks;
+    uint64_t saved_bits = stats.bits;
+
+    double coded = 0;
+    for (int attempt = 0;; attempt++) {
         headerEncoding(&bitstream);
+        encodeBlock(block_dwt, SMR, bandenergy, bitstream, budget);
+        coded = (double)(bitstream.size() - mark);
+        if (coded <= allowance) {
+            break;
+        }
 
-        std::vector<double> buffer_in(bl, 0);
-        std::copy(sig.begin() + (long)(b * bl), sig.begin() + (long)((b + 1) * bl), buffer_in.begin());
-        std::vector<double> wavelets = DWT(buffer_in, dwtlevel);
+        bitstream.resize(mark);
+        arithmetic = saved;
+        stats.blocks = saved_blocks;
+        stats.bits = saved_bits;
+        if (attempt == RATE_RETRIES || budget == 1) {
+            // a block without content always fits
+            headerEncoding(&bitstream);
+            arithmetic_stream.clear();
+            lengthEncoding(bitstream, arithmetic_stream);
+            stats.addBlock(lengthbits);
+            coded = rate_overhead;
+            break;
+        }
+        budget = std::max(1, std::min(budget - 1, (int)(budget * allowance / coded)));
+    }
 
-        pmResult pmres = pm.getSMR(buffer_in);
-        encodeBlock(wavelets, pmres.SMR, pmres.bandenergy, bitstream, bitbudget);
+    if (coded > rate_overhead) {
+        double sample = (coded - rate_overhead) / budget;
+        rate_bits_per_budget += RATE_SMOOTHING * (sample - rate_bits_per_budget);
     }
+    rate_fullness = std::max(0.0, rate_fullness + coded - rate_drain);
+}
 
-    return bitstream;
+/**
+ * @brief estimate the perceptual demand of a block: the bits needed to push the quantization noise of every band below
+ * its masking threshold, at about 6 dB per bit and coefficient
+ * @param SMR signal-to-mask ratio
+ * @return demand in bits
+ */
+auto Encoder::perceptualDemand(const std::vector<double>& SMR) const -> double {
+    double demand = 0;
+    for (int band = 0; band < l_book; band++) {
+        if (std::isfinite(SMR[band]) && SMR[band] > 0) {
+            demand += SMR[band] / DB_PER_BIT * book[band];
+        }
+    }
+    return demand;
+}
+
+/**
+ * @brief encode the signal in independently decodable slices and append the slice index and the slices
+ * @details the context counters are reset at the beginning of every slice and every slice starts at a byte boundary;
+ * slices are distributed over the configured number of threads, the result does not depend on the thread count; with
+ * rate control, the slices are encoded one after another, as the leaky bucket continues across them
+ * @param numblocks number of blocks of the signal
+ * @param encodeRange function encoding a range of blocks with a given encoder
+ * @param bitstream bitstream to append to
+ */
+void Encoder::encodeSlices(size_t numblocks, const SliceFunction& encodeRange, BitWriter& bitstream) {
+    size_t blocks = sliceBlocks();
+    size_t slices = (numblocks + blocks - 1) / blocks;
+    slice_streams.resize(slices);
+
+    // helper encoders for the additional threads; the calling encoder is worker 0
+    int slice_threads = (rate_kbps > 0) ? 1 : threads;
+    int workers = resolveThreads(slice_threads, slices);
+    while ((int)slice_workers.size() < workers - 1) {
+        slice_workers.push_back(std::make_unique<Encoder>(bl, fs, maxChannels, planning));
+    }
+    for (auto& worker : slice_workers) {
+        worker->setEntropyCoder(coder);
+        worker->setScalable(scalable);
+    }
+
+    parallelFor(slices, slice_threads, [&](size_t s, int worker) {
+        Encoder& encoder = (worker == 0) ? *this : *slice_workers[worker - 1];
+        BitWriter& out = slice_streams[s];
+        out.clear();
+        encoder.arithmetic.resetCounter();
+        size_t first = s * blocks;
+        encodeRange(encoder, first, std::min(first + blocks, numblocks), out);
+        alignToByte(out);
+    });
+    if (STATS_ENABLED) {
+        for (auto& worker : slice_workers) {
+            stats.merge(worker->stats);
+            worker->stats.reset();
+        }
+    }
+
+    SliceIndex index;
+    index.slice_blocks = (int)blocks;
+    index.offsets.reserve(slices);
+    size_t offset = 0;
+    for (const auto& slice : slice_streams) {
+        index.offsets.push_back(offset);
+        offset += slice.sizeBytes();
+    }
+    writeSliceIndex(index, bitstream);
+    for (const auto& slice : slice_streams) {
+        bitstream.append(slice);
+    }
+}
+
+/**
+ * @brief select the entropy coder; the range coder is signalled in the stream header
+ * @param coder entropy coder
+ */
+void Encoder::setEntropyCoder(EntropyCoder coder) {
+    this->coder = coder;
+    arithmetic.setCoder(coder);
+}
+
+/**
+ * @brief enable scalable streams: the coded stream of every block can be truncated at any byte and stays decodable
+ * @details the context counters are reset for every block and the entropy coder is terminated, so the decoder never
+ * reads behind the end of a block; truncate1D and truncateMD of the decoder cut the blocks of an encoded stream
+ * @param scalable true to enable scalable streams
+ */
+void Encoder::setScalable(bool scalable) {
+    this->scalable = scalable;
+    arithmetic.setScalable(scalable);
+}
+
+/**
+ * @brief enable seekable streams, whose samples can be decoded without decoding the preceding slices
+ * @details the stream carries a container info with the sampling frequency, block length, channel count and sample
+ * count instead of the sampling frequency code and the channel count; the slice index serves as block index, so the
+ * slices are the seek granularity; without slices set by setSlices, SEEK_BLOCKS_DEFAULT blocks per slice are used
+ * @param seekable true to enable seekable streams
+ */
+void Encoder::setSeekable(bool seekable) {
+    this->seekable = seekable;
+}
+
+/**
+ * @brief enable slices: the context counters are reset every slice_blocks blocks and the byte offset of each slice is
+ * stored in the stream, so the slices can be encoded and decoded independently
+ * @param slice_blocks blocks per slice (for multichannel signals: blocks per channel); 0 disables slices
+ */
+void Encoder::setSlices(int slice_blocks) {
+    this->slice_blocks = std::clamp(slice_blocks, 0, SLICE_BLOCKS_MAX);
+}
+
+/**
+ * @brief set the number of threads used to encode slices
+ * @param threads number of threads; 0 selects the number of hardware threads
+ */
+void Encoder::setThreads(int threads) {
+    this->threads = threads;
+}
+
+/**
+ * @brief enable rate control: the bit budget of every block is adapted, so the coded stream fits a target rate
+ * @details the coded blocks fill a leaky bucket of buffer_bits bits that is drained with the target rate; the bucket
+ * never overflows, so the stream can be sent over a link of the target rate with a buffer of buffer_bits bits. The
+ * bitbudget passed to the encoding functions is the upper limit for the budget of a block.
+ * @param kbps target rate in kbit/s; 0 disables rate control
+ * @param buffer_bits size of the bucket in bits
+ * @param lookahead number of blocks after the current one used to distribute the rate by perceptual demand
+ */
+void Encoder::setRateControl(double kbps, int buffer_bits, int lookahead) {
+    rate_kbps = std::max(kbps, 0.0);
+    rate_buffer = std::max(buffer_bits, 0);
+    rate_lookahead = std::max(lookahead, 0);
+}
+
+/**
+ * @brief get the per-stage timing and counters accumulated since construction or the last resetStats
+ * @details the values are only recorded if the library is built with VC_PWQ_STATS; the statistics of the slice
+ * threads are included
+ * @return statistics
+ */
+auto Encoder::getStats() const -> const Stats& {
+    return stats;
+}
+
+/**
+ * @brief set the statistics to zero
+ */
+void Encoder::resetStats() {
+    stats.reset();
 }
 
 /**
@@ -183,108 +633,227 @@ auto Encoder::encode1D(std::vector<double>& sig, int bitbudget) -> std::vector<c
  * @param bandenergy bandenergy
  * @param bitstream    bitstream to write to
  * @param bitbudget    limit for bitallocation
- * @return quantized signal block
+ * @return quantized signal block; valid until the next block is encoded
  */
 auto Encoder::encodeBlock(std::vector<double>& block_dwt,
-                          std::vector<double> SMR,
-                          std::vector<double> bandenergy,
-                          std::vector<char>& bitstream,
-                          int bitbudget) -> std::vector<double> {
-
-    std::vector<double> block_dwt_quant(bl, 0);
-    std::vector<int> block_intquant(bl, 0);
-    // double *sig_pointer = psig;
-    std::vector<double> SNR(l_book, 0);
-    std::vector<double> MNR(l_book, 0);
-    std::vector<double> noiseenergy(l_book, 0);
-    std::vector<int> bitalloc(l_book, 0);
-    int bitalloc_sum = 0;
+                          const std::vector<double>& SMR,
+                          const std::vector<double>& bandenergy,
+                          BitWriter& bitstream,
+                          int bitbudget) -> const std::vector<double>& {
+
+    std::fill(block_dwt_quant.begin(), block_dwt_quant.end(), 0);
+    std::fill(block_bitalloc.begin(), block_bitalloc.end(), 0);
+    std::fill(block_quantbits.begin(), block_quantbits.end(), 0);
 
     // if the signal contains only zeros
     if (checkZeros(block_dwt, bl)) {
-        std::vector<char> blockstream;
-        lengthEncoding(bitstream, blockstream);
+        arithmetic_stream.clear();
+        lengthEncoding(bitstream, arithmetic_stream);
+        stats.addBlock(lengthbits);
     } else {
         double qwavmax = 0;
-        std::vector<char> bitwavmax;
-        bitwavmax.reserve(WAVMAXLENGTH);
-        maximumWaveletCoefficient(block_dwt, &qwavmax, &bitwavmax);
-
-        // Quantization
-        bitalloc_sum = 0;
-        for (int i = 0; i < bl; i++) {
-            block_dwt_quant[i] = 0;
+        {
+            StageTimer timer(stats, Stage::QUANTIZATION);
+            block_bitwavmax.clear();
+            maximumWaveletCoefficient(block_dwt, &qwavmax, &block_bitwavmax);
         }
 
-        int i = 0;
-        for (int block = 0; block < l_book; block++) {
-            for (; i < book_cumulative[block + 1]; i++) {
-                noiseenergy[block] += pow(block_dwt[i] - block_dwt_quant[i], 2);
-            }
-        }
+        allocateBits(block_dwt, qwavmax, SMR, bandenergy, bitbudget, block_bitalloc, block_quantbits);
 
-        while (bitalloc_sum < bitbudget) {
-            updateNoise(bandenergy, noiseenergy, SNR, MNR, SMR);
-            for (int i = 0; i < l_book; i++) {
-                if (bitalloc[i] >= MAX_BITS) {
-                    MNR[i] = INFINITY;
+        int bitmax = findMax(block_bitalloc);
+        {
+            StageTimer timer(stats, Stage::QUANTIZATION);
+
+            // Quantization, once per band with the final allocation
+            for (int band = 0; band < l_book; band++) {
+                if (block_quantbits[band] > 0) {
+                    uniformQuant(
+                        block_dwt, block_dwt_quant, book_cumulative[band], book[band], qwavmax, block_quantbits[band]);
                 }
             }
-            int index = findMinInd(MNR);
-            if (bitalloc_sum - bitalloc[l_book - 1] >= MAX_BITS * dwtlevel) {
-                int temp = bitalloc[l_book - 1];
-                bitalloc[l_book - 1] = bitbudget - MAX_BITS * dwtlevel;
-                bitalloc_sum += bitalloc[l_book - 1] - temp;
-            } else {
-                bitalloc[index]++;
-                bitalloc_sum++;
+
+            // scale signal to int values
+            int intmax = 1 << bitmax;
+            double multiplicator = (double)intmax / (double)qwavmax;
+            for (int i = 0; i < bl; i++) {
+                block_intquant[i] = (int)round((block_dwt_quant[i] * multiplicator));
             }
+        }
+        losslessEncoding(block_intquant, block_bitwavmax, bitmax, bitstream);
+    }
+    return block_dwt_quant;
+}
 
-            uniformQuant(block_dwt, block_dwt_quant, book_cumulative[index], book[index], qwavmax, bitalloc[index]);
+/**
+ * @brief greedy bit allocation; each bit goes to the wavelet band with the lowest Mask-to-Noise-Ratio
+ * @details the quantization noise of a band is computed from the normalized coefficient magnitudes without writing the
+ * quantized values, and only the MNR of the band that received a bit is updated per iteration
+ * @param block_dwt input signal block
+ * @param qwavmax quantized maximum wavelet coefficient
+ * @param SMR Signal-to-Mask-Ratio
+ * @param bandenergy bandenergy
+ * @param bitbudget limit for bitallocation
+ * @param bitalloc allocated bits per band, output variable
+ * @param quantbits bits the band has to be quantized with, output variable; 0 if the band stays zero
+ */
+void Encoder::allocateBits(std::vector<double>& block_dwt,
+                           double qwavmax,
+                           const std::vector<double>& SMR,
+                           const std::vector<double>& bandenergy,
+                           int bitbudget,
+                           std::vector<int>& bitalloc,
+                           std::vector<int>& quantbits) {
+    StageTimer timer(stats, Stage::BIT_ALLOCATION);
+
+    for (int i = 0; i < bl; i++) {
+        block_sign[i] = sgn(block_dwt[i]);
+        block_mag[i] = std::abs(block_dwt[i]) / qwavmax;
+    }
 
-            noiseenergy[index] = 0;
-            int i = book_cumulative[index];
-            for (; i < book_cumulative[index + 1]; i++) {
-                noiseenergy[index] += pow(block_dwt[i] - block_dwt_quant[i], 2);
-            }
+    std::vector<double>& MNR = block_MNR;
+    for (int band = 0; band < l_book; band++) {
+        updateNoise(band, bandNoise(block_dwt, band, qwavmax, 0), bandenergy, SMR, MNR, bitalloc);
+    }
+
+    int bitalloc_sum = 0;
+    int iterations = 0;
+    while (bitalloc_sum < bitbudget) {
+        iterations++;
+        int index = findMinInd(MNR);
+        if (bitalloc_sum - bitalloc[l_book - 1] >= MAX_BITS * dwtlevel) {
+            int temp = bitalloc[l_book - 1];
+            bitalloc[l_book - 1] = bitbudget - MAX_BITS * dwtlevel;
+            bitalloc_sum += bitalloc[l_book - 1] - temp;
+        } else {
+            bitalloc[index]++;
+            bitalloc_sum++;
+        }
+
+        quantbits[index] = bitalloc[index];
+        updateNoise(index, bandNoise(block_dwt, index, qwavmax, bitalloc[index]), bandenergy, SMR, MNR, bitalloc);
+    }
+    stats.addAllocationIterations(iterations);
+}
+
+/**
+ * @brief quantization noise energy of a wavelet band
+ * @details equivalent to the squared error of uniformQuant; expects block_sign and block_mag to be set for the block
+ * @param block_dwt input signal block
+ * @param band index of the wavelet band
+ * @param max maximum value for quantization
+ * @param bits bit depth; for 0 the band is not quantized and the noise equals the band energy
+ * @return noise energy
+ */
+auto Encoder::bandNoise(std::vector<double>& block_dwt, int band, double max, int bits) const -> double {
+    double noise = 0;
+    if (bits == 0) {
+        for (int i = book_cumulative[band]; i < book_cumulative[band + 1]; i++) {
+            noise += block_dwt[i] * block_dwt[i];
         }
+        return noise;
+    }
 
-        // scale signal to int values
-        int bitmax = findMax(bitalloc);
-        int intmax = 1 << bitmax;
-        double multiplicator = (double)intmax / (double)qwavmax;
-        for (int i = 0; i < bl; i++) {
-            block_intquant[i] = (int)round((block_dwt_quant[i] * multiplicator));
+    // |x| / delta equals |x| / max * 2^bits exactly, as delta = max / 2^bits
+    double delta = max / (1 << bits);
+    double max_q = delta * ((1 << bits) - 1);
+    auto scale = (double)(1 << bits);
+    for (int i = book_cumulative[band]; i < book_cumulative[band + 1]; i++) {
+        double q = block_sign[i] * delta * floor(block_mag[i] * scale + HALF_QUANT);
+        if (std::abs(q) > max_q) {
+            q = block_sign[i] * max_q;
         }
-        losslessEncoding(block_intquant, bitwavmax, bitmax, bitstream);
+        double d = block_dwt[i] - q;
+        noise += d * d;
     }
-    return block_dwt_quant;
+    return noise;
 }
 
 /**
  * @brief lossless encoding of a signal block
+ * @details the symbols are entropy coded while SPIHT runs, so their coding time is part of the SPIHT stage; the entropy
+ * coding stage covers the completion of the coded block and its transfer to the bitstream
  * @param block_intquant input signal block
  * @param bitwavmax maximum amplitude
  * @param bitmax maximum allocated bits
  * @param bitstream    bitstream to write to
  */
 void Encoder::losslessEncoding(std::vector<int>& block_intquant,
-                               std::vector<char>& bitwavmax,
+                               BitWriter& bitwavmax,
                                int bitmax,
-                               std::vector<char>& bitstream) {
-    std::vector<char> SPIHT_stream;
-    SPIHT_stream.reserve(BINARY_RESERVE);
-    std::vector<int> SPIHT_context;
-    SPIHT_context.reserve(BINARY_RESERVE);
-    spiht.encode(block_intquant, dwtlevel, &bitwavmax, bitmax, SPIHT_stream, SPIHT_context);
-
-    std::vector<char> arithmetic_stream;
-    arithmetic_stream.reserve(BINARY_RESERVE);
-    arithmetic.encode(&SPIHT_stream, &SPIHT_context, &arithmetic_stream);
+                               BitWriter& bitstream) {
+    {
+        StageTimer timer(stats, Stage::SPIHT);
+        if (scalable) {
+            arithmetic.resetCounter();
+        }
+        arithmetic_stream.clear();
+        arithmetic.start(&arithmetic_stream);
+        spiht.encode(block_intquant, dwtlevel, &bitwavmax, bitmax, arithmetic);
+    }
+    StageTimer timer(stats, Stage::ENTROPY_CODING);
+    arithmetic.finish();
     arithmetic.rescaleCounter();
 
     lengthEncoding(bitstream, arithmetic_stream);
-    bitstream.insert(bitstream.end(), arithmetic_stream.begin(), arithmetic_stream.end());
+    bitstream.append(arithmetic_stream);
+    stats.addBlock(lengthbits + arithmetic_stream.size());
+}
+
+/**
+ * @brief write the stream header, if a coding tool beyond the original bitstream format is selected
+ * @param bitstream bitstream to write to
+ */
+void Encoder::streamHeaderEncoding(BitWriter* bitstream) const {
+    StreamHeader header;
+    if (coder == EntropyCoder::RANGE) {
+        header.flags |= FLAG_RANGE_CODER;
+    }
+    if (sliceBlocks() > 0) {
+        header.flags |= FLAG_SLICES;
+    }
+    if (scalable) {
+        header.flags |= FLAG_SCALABLE;
+    }
+    header.version = STREAM_VERSION_BASE;
+    if (seekable) {
+        header.flags |= FLAG_SEEKABLE;
+        header.version = STREAM_VERSION_SEEKABLE;
+    }
+    if (!header.isLegacy()) {
+        writeStreamHeader(header, *bitstream);
+    }
+}
+
+/**
+ * @brief encode the container info of a seekable stream
+ * @param channels number of channels
+ * @param samples number of samples per channel
+ * @param bitstream bitstream to write to
+ * @return status (0 if success, -1 if too many channels in signal)
+ */
+auto Encoder::containerEncoding(int channels, size_t samples, BitWriter* bitstream) const -> int {
+    if (channels > CONTAINER_CHANNELS_MAX) {
+        std::cout << "too many channels for a seekable stream" << std::endl;
+        return -1;
+    }
+    ContainerInfo info;
+    info.fs = fs;
+    info.bl = bl;
+    info.channels = channels;
+    info.samples = samples;
+    writeContainerInfo(info, *bitstream);
+    return 0;
+}
+
+/**
+ * @brief blocks per slice
+ * @return blocks per slice set by setSlices; SEEK_BLOCKS_DEFAULT for seekable streams without slices; 0 without slices
+ */
+auto Encoder::sliceBlocks() const -> int {
+    if (slice_blocks == 0 && seekable) {
+        return SEEK_BLOCKS_DEFAULT;
+    }
+    return slice_blocks;
 }
 
 /**
@@ -292,20 +861,20 @@ void Encoder::losslessEncoding(std::vector<int>& block_intquant,
  * @details only discrete values are possible; change for concrete application (decoder accordingly, too)
  * @param bitstream bitstream to write to
  */
-void Encoder::fsEncode(std::vector<char>* bitstream) const {
+void Encoder::fsEncode(BitWriter* bitstream) const {
 
     if (fs == FS_0) {
-        bitstream->push_back(0);
-        bitstream->push_back(0);
+        bitstream->writeBit(0);
+        bitstream->writeBit(0);
     } else if (fs == FS_1) {
-        bitstream->push_back(0);
-        bitstream->push_back(1);
+        bitstream->writeBit(0);
+        bitstream->writeBit(1);
     } else if (fs == FS_2) {
-        bitstream->push_back(1);
-        bitstream->push_back(0);
+        bitstream->writeBit(1);
+        bitstream->writeBit(0);
     } else {
-        bitstream->push_back(1);
-        bitstream->push_back(1);
+        bitstream->writeBit(1);
+        bitstream->writeBit(1);
     }
 }
 
@@ -315,12 +884,12 @@ void Encoder::fsEncode(std::vector<char>* bitstream) const {
  * @param bitstream bitstream to write to
  * @return status (0 if success, -1 if too many channels in signal)
  */
-auto Encoder::encodeChannels(int channels, std::vector<char>* bitstream) const -> int {
+auto Encoder::encodeChannels(int channels, BitWriter* bitstream) const -> int {
     if (channels > ((int)(pow(2, channelbits) - 1))) {
         std::cout << "too many channels; adjust maxChannels at constructor" << std::endl;
         return -1;
     }
-    de2bi(channels, bitstream, channelbits);
+    bitstream->write(channels, channelbits);
     return 0;
 }
 
@@ -328,36 +897,36 @@ auto Encoder::encodeChannels(int channels, std::vector<char>* bitstream) const -
  * @brief encode blocklength
  * @param bitstream bitstream to write to
  */
-void Encoder::headerEncoding(std::vector<char>* bitstream) const {
+void Encoder::headerEncoding(BitWriter* bitstream) const {
 
     switch (bl) {
         case BL_0:
-            bitstream->push_back(1);
+            bitstream->writeBit(1);
             break;
 
         case BL_1:
-            bitstream->push_back(0);
-            bitstream->push_back(1);
+            bitstream->writeBit(0);
+            bitstream->writeBit(1);
             break;
 
         case BL_2:
-            bitstream->push_back(0);
-            bitstream->push_back(0);
-            bitstream->push_back(1);
+            bitstream->writeBit(0);
+            bitstream->writeBit(0);
+            bitstream->writeBit(1);
             break;
 
         case BL_3:
-            bitstream->push_back(0);
-            bitstream->push_back(0);
-            bitstream->push_back(0);
-            bitstream->push_back(0);
+            bitstream->writeBit(0);
+            bitstream->writeBit(0);
+            bitstream->writeBit(0);
+            bitstream->writeBit(0);
             break;
 
         case BL_4:
-            bitstream->push_back(0);
-            bitstream->push_back(0);
-            bitstream->push_back(0);
-            bitstream->push_back(1);
+            bitstream->writeBit(0);
+            bitstream->writeBit(0);
+            bitstream->writeBit(0);
+            bitstream->writeBit(1);
             break;
 
         default:
@@ -370,14 +939,14 @@ void Encoder::headerEncoding(std::vector<char>* bitstream) const {
  * @param outstream bitstream to write to
  * @param blockstream stream of signal block
  */
-void Encoder::lengthEncoding(std::vector<char>& outstream, std::vector<char>& blockstream) const {
+void Encoder::lengthEncoding(BitWriter& outstream, BitWriter& blockstream) const {
     int segmentlength = (int)blockstream.size();
     int max_size = pow(2, lengthbits) - 1;
     if (segmentlength > max_size) {
         blockstream.resize(max_size);
         segmentlength = max_size;
     }
-    de2bi(segmentlength, &outstream, lengthbits);
+    outstream.write(segmentlength, lengthbits);
 }
 
 /**
@@ -386,7 +955,7 @@ void Encoder::lengthEncoding(std::vector<char>& outstream, std::vector<char>& bl
  * @param qwavmax   pointer for returning maximum wavelet coefficient
  * @param bitwavmax bitstream vector for encoding
  */
-void Encoder::maximumWaveletCoefficient(std::vector<double>& sig, double* qwavmax, std::vector<char>* bitwavmax) {
+void Encoder::maximumWaveletCoefficient(std::vector<double>& sig, double* qwavmax, BitWriter* bitwavmax) {
 
     double wavmax = findMax(sig);
 
@@ -406,31 +975,31 @@ void Encoder::maximumWaveletCoefficient(std::vector<double>& sig, double* qwavma
     }
 
     *qwavmax = maxQuant(wavmax - (double)integerpart, integerbits, fractionbits) + integerpart;
-    bitwavmax->push_back(mode);
-    bitwavmax->resize(WAVMAXLENGTH);
-    de2bi((int)((*qwavmax - (double)integerpart) * pow(2, (double)fractionbits)),
-          bitwavmax,
-          integerbits + fractionbits,
-          1);
+    bitwavmax->writeBit(mode);
+    bitwavmax->write((int)((*qwavmax - (double)integerpart) * pow(2, (double)fractionbits)), integerbits + fractionbits);
 }
 
 /**
- * @brief update quantization noise in wavelet bands
- * @details beside noiseenergy, also SNR an MNR will be updated respectively
+ * @brief update the Mask-to-Noise-Ratio of a wavelet band after its quantization noise changed
+ * @details bands which reached the maximum bit depth get an infinite MNR, so they are not selected anymore
+ * @param band index of the wavelet band
+ * @param noiseenergy quantization noise of the band
  * @param bandenergy energy of the original signal
- * @param noiseenergy quantization noise
- * @param SNR Signal-to-Noise-Ratio
- * @param MNR Mask-to-Noise-Ratio
  * @param SMR Signal-to-Mask-Ratio
+ * @param MNR Mask-to-Noise-Ratio
+ * @param bitalloc allocated bits per band
  */
-void Encoder::updateNoise(std::vector<double>& bandenergy,
-                          std::vector<double>& noiseenergy,
-                          std::vector<double>& SNR,
+void Encoder::updateNoise(int band,
+                          double noiseenergy,
+                          const std::vector<double>& bandenergy,
+                          const std::vector<double>& SMR,
                           std::vector<double>& MNR,
-                          std::vector<double>& SMR) const {
-    for (int i = 0; i < l_book; i++) {
-        SNR[i] = 10 * log10(bandenergy[i] / noiseenergy[i]);
-        MNR[i] = SNR[i] - SMR[i];
+                          const std::vector<int>& bitalloc) const {
+    if (bitalloc[band] >= MAX_BITS) {
+        MNR[band] = INFINITY;
+    } else {
+        double SNR = 10 * log10(bandenergy[band] / noiseenergy);
+        MNR[band] = SNR - SMR[band];
     }
 }
 
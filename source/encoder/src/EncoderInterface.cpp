@@ -18,12 +18,15 @@ namespace VC_PWQ {
 /**
  * @brief constructor
  * @param fs_new sampling frequency, only needed for txt files
+ * @param planning FFTW planning effort used by the encoders
  */
-EncoderInterface::EncoderInterface(int fs_new) : fs(fs_new) {}
+EncoderInterface::EncoderInterface(int fs_new, PlanningMode planning) : fs(fs_new), planning(planning) {}
 
 /**
  * @brief encode all signals in a folder using the multichannel codec and puts it in defined folder
- * @details if the output folder does not exist, it is generated
+ * @details if the output folder does not exist, it is generated; the files are distributed over the configured number
+ * of threads, each thread reuses its encoder for consecutive files. The encoded files do not depend on the number of
+ * threads.
  * @param inFolder folder of the input signals
  * @param outFolder folder of the encoded signals
  * @param bl block length
@@ -39,10 +42,6 @@ auto EncoderInterface::encodeFolderMD(const std::string& inFolder,
                                       std::string appendix,
                                       int maxChannels) const -> int {
 
-    std::string bin = ".binary";
-    std::string wav = ".wav";
-    std::string txt = ".txt";
-    std::string csv = ".csv";
     if (!std::filesystem::is_directory(inFolder)) {
         std::cout << "folder not found: " << inFolder << std::endl;
         return -1;
@@ -57,34 +56,29 @@ auto EncoderInterface::encodeFolderMD(const std::string& inFolder,
         create_directory(path_products);
     }
 
-    std::string prefix = outFolder + "/";  // save folder
-
-    for (const auto& entry : std::filesystem::directory_iterator(inFolder)) {
+    const auto files = collectFiles(inFolder, outFolder, appendix);
+    std::vector<EncoderSlot> slots(resolveThreads(threads, files.size()));
+    std::mutex print_mutex;
 
-        std::string filename = entry.path();
-
-        if (filename.find(wav) != std::string::npos || filename.find(txt) != std::string::npos ||
-            filename.find(csv) != std::string::npos) {
-
-            std::string productname = filename;
-            productname.erase(0, inFolder.size() + 1);  // folder
-            productname.insert(0, prefix);
-            auto pos_appendix = (long)productname.find('.');
-            productname.erase(productname.begin() + pos_appendix, productname.end());
-            productname.append(appendix.begin(), appendix.end());
-            productname.append(bin.begin(), bin.end());
-            std::vector<std::vector<double>> sig_rec;
-            std::cout << "input filename: " << filename << std::endl;
-            std::cout << "output filename: " << productname << std::endl;
-            encodeFileMD(filename, productname, bl, bitbudget, maxChannels);
+    parallelFor(files.size(), threads, [&](size_t task, int worker) {
+        const auto& [filename, productname] = files[task];
+        int status = encodeFileMD(filename, productname, bl, bitbudget, maxChannels, slots[worker]);
+        std::lock_guard<std::mutex> lock(print_mutex);
+        std::cout << "input filename: " << filename << std::endl;
+        if (status == -1) {
+            std::cout << "file could not be encoded" << std::endl;
+            return;
         }
-    }
+        std::cout << "output filename: " << productname << std::endl;
+    });
     return 0;
 }
 
 /**
  * @brief encode all signals in a folder using the single channel codec and puts it in defined folder
- * @details if the output folder does not exist, it is generated
+ * @details if the output folder does not exist, it is generated; the files are distributed over the configured number
+ * of threads, each thread reuses its encoder for consecutive files. The encoded files do not depend on the number of
+ * threads.
  * @param inFolder folder of the input signals
  * @param outFolder folder of the encoded signals
  * @param bl blocklength
@@ -97,10 +91,6 @@ auto EncoderInterface::encodeFolder1D(const std::string& inFolder,
                                       int bl,
                                       int bitbudget,
                                       std::string appendix) const -> int {
-    std::string bin = ".binary";
-    std::string wav = ".wav";
-    std::string txt = ".txt";
-    std::string csv = ".csv";
     std::filesystem::path path(inFolder);
     std::filesystem::path path_products(outFolder);
     if (path.empty()) {
@@ -111,8 +101,42 @@ auto EncoderInterface::encodeFolder1D(const std::string& inFolder,
         create_directory(path_products);
     }
 
+    const auto files = collectFiles(inFolder, outFolder, appendix);
+    std::vector<EncoderSlot> slots(resolveThreads(threads, files.size()));
+    std::mutex print_mutex;
+
+    parallelFor(files.size(), threads, [&](size_t task, int worker) {
+        const auto& [filename, productname] = files[task];
+        int status = encodeFile1D(filename, productname, bl, bitbudget, slots[worker]);
+        std::lock_guard<std::mutex> lock(print_mutex);
+        std::cout << "input filename: " << filename << std::endl;
+        if (status == -1) {
+            std::cout << "file could not be encoded" << std::endl;
+            return;
+        }
+        std::cout << "output filename: " << productname << std::endl;
+    });
+    return 0;
+}
+
+/**
+ * @brief list the signal files in a folder together with the names of the encoded files
+ * @param inFolder folder of the input signals
+ * @param outFolder folder of the encoded signals
+ * @param appendix appendix to the file name
+ * @return pairs of input and output filename
+ */
+auto EncoderInterface::collectFiles(const std::string& inFolder,
+                                    const std::string& outFolder,
+                                    const std::string& appendix) -> std::vector<std::pair<std::string, std::string>> {
+    std::string bin = ".binary";
+    std::string wav = ".wav";
+    std::string txt = ".txt";
+    std::string csv = ".csv";
+
     std::string prefix = outFolder + "/";  // save folder
 
+    std::vector<std::pair<std::string, std::string>> files;
     for (const auto& entry : std::filesystem::directory_iterator(inFolder)) {
 
         std::string filename = entry.path();
@@ -127,13 +151,10 @@ auto EncoderInterface::encodeFolder1D(const std::string& inFolder,
             productname.erase(productname.begin() + pos_appendix, productname.end());
             productname.append(appendix.begin(), appendix.end());
             productname.append(bin.begin(), bin.end());
-            std::vector<std::vector<double>> sig_rec;
-            encodeFile1D(filename, productname, bl, bitbudget);
-            std::cout << "input filename: " << filename << std::endl;
-            std::cout << "output filename: " << productname << std::endl;
+            files.emplace_back(filename, productname);
         }
     }
-    return 0;
+    return files;
 }
 
 /**
@@ -150,26 +171,63 @@ auto EncoderInterface::encodeFileMD(const std::string& inFile,
                                     int bl,
                                     int bitbudget,
                                     int maxChannels) const -> int {
+    EncoderSlot slot;
+    return encodeFileMD(inFile, outFile, bl, bitbudget, maxChannels, slot);
+}
+
+/**
+ * @brief encode a multichannel signal using the single channel codec (extended to multichannel)
+ * @param inFile filename of the input signal
+ * @param outFile filename of the input signal
+ * @param bl blocklength
+ * @param bitbudget bitbudget for the encoder
+ * @param maxChannels maximum number of channels
+ * @param slot encoder of the calling worker; reused if the settings match
+ * @return status (-1 for failed, 0 for success)
+ */
+auto EncoderInterface::encodeFileMD(const std::string& inFile,
+                                    const std::string& outFile,
+                                    int bl,
+                                    int bitbudget,
+                                    int maxChannels,
+                                    EncoderSlot& slot) const -> int {
+    AudioFile<double> file;
     std::vector<std::vector<double>> buffer;
+    bool wav = inFile.find(".wav") != std::string::npos;
     int fs = 0;
-    if (inFile.find(".wav") != std::string::npos) {
-        AudioFile<double> file(inFile);
-        buffer = file.samples;
-        fs = (int)file.getSampleRate();
-    } else {
-        readTXTMatrix(buffer, inFile);
-        if (this->fs == 0) {
-            std::cout << "please specify a sampling frequency for .txt files" << std::endl;
-            return -1;
+    Stats file_stats;
+    {
+        StageTimer timer(file_stats, Stage::IO);
+        if (wav) {
+            if (!file.load(inFile) || file.samples.empty()) {
+                std::cout << "could not read " << inFile << std::endl;
+                return -1;
+            }
+            fs = (int)file.getSampleRate();
+        } else {
+            if (readTXTMatrix(buffer, inFile) == 0) {
+                std::cout << "could not read " << inFile << std::endl;
+                return -1;
+            }
+            if (this->fs == 0) {
+                std::cout << "please specify a sampling frequency for .txt files" << std::endl;
+                return -1;
+            }
+            fs = this->fs;
         }
-        fs = this->fs;
     }
 
-    Encoder encoder(bl, fs, maxChannels);
+    Encoder& encoder = getEncoder(slot, bl, fs, maxChannels);
 
-    std::vector<char> bitstream = encoder.encodeMD(buffer, bitbudget);
+    // the channels of the .wav file are encoded in place
+    const std::vector<std::vector<double>>& sig = wav ? file.samples : buffer;
+    BitWriter bitstream = encoder.encodeMD(sig, bitbudget);
 
-    saveAsBinary(outFile, bitstream);
+    {
+        StageTimer timer(file_stats, Stage::IO);
+        saveAsBinary(outFile, bitstream);
+    }
+    recordStats(encoder, file_stats);
 
     return 0;
 }
@@ -184,37 +242,187 @@ auto EncoderInterface::encodeFileMD(const std::string& inFile,
  */
 auto EncoderInterface::encodeFile1D(const std::string& inFile, const std::string& outFile, int bl, int bitbudget) const
     -> int {
+    EncoderSlot slot;
+    return encodeFile1D(inFile, outFile, bl, bitbudget, slot);
+}
+
+/**
+ * @brief encode a single channel signal
+ * @param inFile filename of the input signal
+ * @param outFile filename of the input signal
+ * @param bl blocklength
+ * @param bitbudget bitbudget for the encoder
+ * @param slot encoder of the calling worker; reused if the settings match
+ * @return status (-1 for failed, 0 for success)
+ */
+auto EncoderInterface::encodeFile1D(const std::string& inFile,
+                                    const std::string& outFile,
+                                    int bl,
+                                    int bitbudget,
+                                    EncoderSlot& slot) const -> int {
     std::vector<double> buffer;
     int fs = 0;
     size_t channels = 0;
-    if (inFile.find(".wav") != std::string::npos) {
-        AudioFile<double> file(inFile);
-        buffer = file.samples.at(0);
-        fs = (int)file.getSampleRate();
-        channels = file.getNumChannels();
-    } else {
-        std::vector<std::vector<double>> buffer_txt;
-        readTXTMatrix(buffer_txt, inFile);
-        buffer = buffer_txt.at(0);
-        channels = buffer_txt.size();
-        if (this->fs == 0) {
-            std::cout << "please specify a sampling frequency for .txt files" << std::endl;
-            return -1;
+    Stats file_stats;
+    {
+        StageTimer timer(file_stats, Stage::IO);
+        if (inFile.find(".wav") != std::string::npos) {
+            AudioFile<double> file;
+            if (!file.load(inFile) || file.samples.empty()) {
+                std::cout << "could not read " << inFile << std::endl;
+                return -1;
+            }
+            buffer = std::move(file.samples[0]);
+            fs = (int)file.getSampleRate();
+            channels = file.getNumChannels();
+        } else {
+            std::vector<std::vector<double>> buffer_txt;
+            if (readTXTMatrix(buffer_txt, inFile) == 0 || buffer_txt.empty()) {
+                std::cout << "could not read " << inFile << std::endl;
+                return -1;
+            }
+            buffer = std::move(buffer_txt[0]);
+            channels = buffer_txt.size();
+            if (this->fs == 0) {
+                std::cout << "please specify a sampling frequency for .txt files" << std::endl;
+                return -1;
+            }
+            fs = this->fs;
         }
-        fs = this->fs;
     }
     if (channels > 1) {
         std::cout << "File contains more than one channel. Only first channel will be encoded" << std::endl;
         std::cout << channels << std::endl;
     }
 
-    Encoder encoder(bl, fs);
+    Encoder& encoder = getEncoder(slot, bl, fs, MAXCHANNELS_DEFAULT);
 
-    std::vector<char> bitstream = encoder.encode1D(buffer, bitbudget);
+    BitWriter bitstream = encoder.encode1D(buffer, bitbudget);
 
-    saveAsBinary(outFile, bitstream);
+    {
+        StageTimer timer(file_stats, Stage::IO);
+        saveAsBinary(outFile, bitstream);
+    }
+    recordStats(encoder, file_stats);
 
     return 0;
 }
 
+/**
+ * @brief get the encoder of a worker, a new encoder is only created if the settings differ from the previous file
+ * @param slot encoder of the worker
+ * @param bl blocklength
+ * @param fs sampling frequency
+ * @param maxChannels maximum number of channels
+ * @return encoder
+ */
+auto EncoderInterface::getEncoder(EncoderSlot& slot, int bl, int fs, int maxChannels) const -> Encoder& {
+    if (!slot.encoder || slot.bl != bl || slot.fs != fs || slot.maxChannels != maxChannels) {
+        slot.encoder = std::make_unique<Encoder>(bl, fs, maxChannels, planning);
+        slot.bl = bl;
+        slot.fs = fs;
+        slot.maxChannels = maxChannels;
+    }
+    slot.encoder->setEntropyCoder(coder);
+    slot.encoder->setSlices(slice_blocks);
+    slot.encoder->setRateControl(rate_kbps, rate_buffer, rate_lookahead);
+    slot.encoder->setScalable(scalable);
+    slot.encoder->setSeekable(seekable);
+    return *slot.encoder;
+}
+
+/**
+ * @brief add the statistics of an encoded file to the statistics of the interface; the encoder statistics are reset
+ * @param encoder encoder of the file
+ * @param file_stats statistics recorded by the interface, i.e. the file I/O
+ */
+void EncoderInterface::recordStats(Encoder& encoder, const Stats& file_stats) const {
+    if (!STATS_ENABLED) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats.merge(encoder.getStats());
+    stats.merge(file_stats);
+    encoder.resetStats();
+}
+
+/**
+ * @brief get the statistics of all files encoded since construction or the last resetStats
+ * @details the values are only recorded if the library is built with VC_PWQ_STATS
+ * @return statistics
+ */
+auto EncoderInterface::getStats() const -> Stats {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats;
+}
+
+/**
+ * @brief set the statistics to zero
+ */
+void EncoderInterface::resetStats() {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats.reset();
+}
+
+/**
+ * @brief write the statistics of all encoded files as JSON file
+ * @param filename output file
+ * @return false if the file could not be written
+ */
+auto EncoderInterface::saveStats(const std::string& filename) const -> bool {
+    return VC_PWQ::saveStats(getStats(), filename);
+}
+
+/**
+ * @brief select the entropy coder used by the encoders
+ * @param coder entropy coder
+ */
+void EncoderInterface::setEntropyCoder(EntropyCoder coder) {
+    this->coder = coder;
+}
+
+/**
+ * @brief set the number of threads used to encode the files of a folder
+ * @param threads number of threads; 0 selects the number of hardware threads
+ */
+void EncoderInterface::setThreads(int threads) {
+    this->threads = threads;
+}
+
+/**
+ * @brief code the signals in independently decodable slices
+ * @param slice_blocks blocks per slice; 0 disables slices
+ */
+void EncoderInterface::setSlices(int slice_blocks) {
+    this->slice_blocks = slice_blocks;
+}
+
+/**
+ * @brief adapt the bit budget of every block to a target rate, see Encoder::setRateControl
+ * @param kbps target rate in kbit/s; 0 disables rate control
+ * @param buffer_bits size of the leaky bucket in bits
+ * @param lookahead number of blocks after the current one used to distribute the rate
+ */
+void EncoderInterface::setRateControl(double kbps, int buffer_bits, int lookahead) {
+    rate_kbps = kbps;
+    rate_buffer = buffer_bits;
+    rate_lookahead = lookahead;
+}
+
+/**
+ * @brief code the signals as scalable streams, whose blocks can be truncated at any byte
+ * @param scalable true to enable scalable streams
+ */
+void EncoderInterface::setScalable(bool scalable) {
+    this->scalable = scalable;
+}
+
+/**
+ * @brief code the signals as seekable streams with container info and block index
+ * @param seekable true to enable seekable streams
+ */
+void EncoderInterface::setSeekable(bool seekable) {
+    this->seekable = seekable;
+}
+
 }  // namespace VC_PWQ
@@ -0,0 +1,174 @@
+//=======================================================================
+/** @file StreamingEncoder.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Push-style encoder for real-time capture: samples are passed in chunks of arbitrary size, every block is encoded as
+ * soon as it is complete and its bytes can be read right away. The latency is bounded to one block.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/StreamingEncoder.hpp"
+
+namespace VC_PWQ {
+
+/**
+ * @brief constructor of the streaming encoder; all buffers are allocated here
+ * @details with one channel the stream has the format of encode1D, otherwise the format of encodeMD; the stream is
+ * byte-identical to the one of the block encoder for the same signal
+ * @param bl_new block length
+ * @param fs_new sampling frequency; only a fixed number of values supported
+ * @param bitbudget limit for bitallocation
+ * @param channels number of channels
+ * @param maxChannels specify maximum number of channels supported; default on 8
+ * @param planning FFTW planning effort for the psychohaptic model
+ */
+StreamingEncoder::StreamingEncoder(
+    int bl_new, int fs_new, int bitbudget, int channels, int maxChannels, PlanningMode planning)
+    : Encoder(bl_new, fs_new, maxChannels, planning),
+      channels(channels),
+      bitbudget(bitbudget),
+      pending(channels, std::vector<double>(bl_new, 0)) {
+
+    if (this->bitbudget > MAX_BITS * l_book) {
+        std::cerr << "bit budget too high, switching to maximum" << std::endl;
+        this->bitbudget = MAX_BITS * l_book;
+    }
+    reserveChannels(channels);
+    output.reserve(BINARY_RESERVE * STREAMING_RESERVE_BLOCKS * channels);
+}
+
+/**
+ * @brief pass interleaved samples to the encoder; every completed block is encoded immediately
+ * @details the encoded bytes are available with read; the first call writes the stream header
+ * @param samples input samples; sample i of channel c is at samples[i * channels + c]
+ * @param frames number of samples per channel
+ * @return number of blocks encoded during this call; -1 if the channel count is not supported
+ */
+auto StreamingEncoder::push(const double* samples, size_t frames) -> int {
+    if (!started) {
+        startStream();
+    }
+    if (status == -1) {
+        return -1;
+    }
+
+    int blocks = 0;
+    size_t frame = 0;
+    while (frame < frames) {
+        size_t count = std::min(frames - frame, (size_t)bl - filled);
+        for (int c = 0; c < channels; c++) {
+            const double* in = samples + frame * channels + c;
+            double* out = pending[c].data() + filled;
+            for (size_t i = 0; i < count; i++) {
+                out[i] = in[i * channels];
+            }
+        }
+        filled += count;
+        frame += count;
+
+        if (filled == (size_t)bl) {
+            encodePending();
+            blocks++;
+        }
+    }
+    return blocks;
+}
+
+/**
+ * @brief complete the stream: the last block is padded with zeros and the final byte is completed
+ * @details the encoder is ready for a new stream afterwards
+ */
+void StreamingEncoder::finish() {
+    if (!started) {
+        startStream();
+    }
+    if (status == 0 && filled > 0) {
+        for (auto& p : pending) {
+            std::fill(p.begin() + (long)filled, p.end(), 0);
+        }
+        encodePending();
+    }
+    output.resize((output.size() + BYTE_SIZE - 1) / BYTE_SIZE * BYTE_SIZE);
+    started = false;
+}
+
+/**
+ * @brief number of bytes that can be read
+ * @return number of complete bytes
+ */
+auto StreamingEncoder::available() const -> size_t {
+    return output.size() / BYTE_SIZE;
+}
+
+/**
+ * @brief read encoded bytes; bytes are only available once they are complete
+ * @param dest destination buffer
+ * @param max size of the destination buffer
+ * @return number of bytes copied
+ */
+auto StreamingEncoder::read(uint8_t* dest, size_t max) -> size_t {
+    size_t bytes = std::min(max, available());
+    std::copy(output.data(), output.data() + bytes, dest);
+    output.discardBytes(bytes);
+    return bytes;
+}
+
+/**
+ * @brief write the stream header, channel count (multichannel streams only) and sampling frequency
+ */
+void StreamingEncoder::startStream() {
+    started = true;
+    status = 0;
+    filled = 0;
+    arithmetic.resetCounter();
+
+    streamHeaderEncoding(&output);
+    if (channels > 1) {
+        status = encodeChannels(channels, &output);
+        if (status == -1) {
+            output.clear();
+            return;
+        }
+    }
+    fsEncode(&output);
+}
+
+/**
+ * @brief encode the buffered block of every channel and append it to the output
+ */
+void StreamingEncoder::encodePending() {
+    if (channels == 1) {
+        headerEncoding(&output);
+        {
+            StageTimer timer(stats, Stage::PSYCHOHAPTIC_MODEL);
+            pm.getSMR(pending[0], block_SMR, block_bandenergy);
+        }
+        {
+            StageTimer timer(stats, Stage::DWT);
+            DWT_inplace(pending[0].data(), bl, dwtlevel, dwt_scratch.data());
+        }
+        encodeBlock(pending[0], block_SMR, block_bandenergy, output, bitbudget);
+    } else {
+        for (int c = 0; c < channels; c++) {
+            std::copy(pending[c].begin(), pending[c].end(), blocksMD.begin() + (long)c * bl);
+            StageTimer timer(stats, Stage::DWT);
+            DWT_inplace(pending[c].data(), bl, dwtlevel, dwt_scratch.data());
+        }
+        {
+            StageTimer timer(stats, Stage::PSYCHOHAPTIC_MODEL);
+            pm.getSMR_Batch(blocksMD, channels, SMR_MD, bandenergy_MD);
+        }
+        for (int c = 0; c < channels; c++) {
+            headerEncoding(&output);
+            encodeBlock(pending[c], SMR_MD[c], bandenergy_MD[c], output, bitbudget);
+        }
+    }
+    filled = 0;
+}
+
+}  // namespace VC_PWQ
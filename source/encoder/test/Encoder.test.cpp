@@ -0,0 +1,280 @@
+//=======================================================================
+/** @file Encoder.test.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/Encoder.hpp"
+#include "../include/StreamingEncoder.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+
+// counting allocator: every allocation of the test binary passes through here
+std::atomic<bool> counting{false};
+std::atomic<size_t> allocations{0};
+
+/**
+ * @brief encoder with access to the block loops, which append to a caller-owned bitstream
+ */
+class TestEncoder : public VC_PWQ::Encoder {
+  public:
+    using Encoder::Encoder;
+    using Encoder::encodeBlocks1D;
+    using Encoder::encodeBlocksMD;
+};
+
+auto testSignal(size_t length, double frequency) -> std::vector<double> {
+    std::vector<double> sig(length);
+    for (size_t i = 0; i < length; i++) {
+        sig[i] = 0.7 * sin(frequency * (double)i) + 0.2 * sin(0.91 * (double)i) * exp(-0.002 * (double)i);  // NOLINT
+    }
+    for (size_t i = length / 3; i < length / 3 + 300 && i < length; i++) {  // NOLINT
+        sig[i] = 0;                                                          // silent blocks
+    }
+    return sig;
+}
+
+/**
+ * @brief interleave the channels of a signal
+ */
+auto interleave(const std::vector<std::vector<double>>& sig) -> std::vector<double> {
+    std::vector<double> interleaved(sig.size() * sig[0].size());
+    for (size_t i = 0; i < sig[0].size(); i++) {
+        for (size_t c = 0; c < sig.size(); c++) {
+            interleaved[i * sig.size() + c] = sig[c][i];
+        }
+    }
+    return interleaved;
+}
+
+/**
+ * @brief encode an interleaved signal with a streaming encoder, pushed and read in chunks of irregular size
+ */
+auto streamEncode(VC_PWQ::StreamingEncoder& encoder, const std::vector<double>& interleaved, int channels)
+    -> std::vector<uint8_t> {
+    static constexpr size_t push_sizes[] = {1, 17, 300, 5, 513, 64};  // NOLINT
+    static constexpr size_t read_sizes[] = {3, 100, 7};               // NOLINT
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> chunk(100);  // NOLINT
+    size_t frames = interleaved.size() / channels;
+    size_t frame = 0;
+    for (size_t i = 0; frame < frames; i++) {
+        size_t count = std::min(push_sizes[i % 6], frames - frame);  // NOLINT
+        if (encoder.push(interleaved.data() + frame * channels, count) < 0) {
+            return {};
+        }
+        frame += count;
+        size_t read = encoder.read(chunk.data(), read_sizes[i % 3]);
+        bytes.insert(bytes.end(), chunk.begin(), chunk.begin() + (long)read);
+    }
+    encoder.finish();
+    while (encoder.available() > 0) {
+        size_t read = encoder.read(chunk.data(), chunk.size());
+        bytes.insert(bytes.end(), chunk.begin(), chunk.begin() + (long)read);
+    }
+    return bytes;
+}
+
+/**
+ * @brief true if the bytes equal the bytes of a bitstream
+ */
+auto sameBytes(const std::vector<uint8_t>& bytes, const VC_PWQ::BitWriter& bitstream) -> bool {
+    return bytes.size() == bitstream.sizeBytes() && std::memcmp(bytes.data(), bitstream.data(), bytes.size()) == 0;
+}
+
+/**
+ * @brief count the allocations of a function
+ */
+template <typename F>
+auto countAllocations(F function) -> size_t {
+    allocations = 0;
+    counting = true;
+    function();
+    counting = false;
+    return allocations;
+}
+
+}  // namespace
+
+auto operator new(std::size_t size) -> void* {
+    if (counting) {
+        allocations++;
+    }
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+    std::free(p);
+}
+
+TEST_CASE("Encoder sessions") {
+
+    static constexpr int bl = 256;
+    static constexpr int fs = 8000;
+    static constexpr int budget = 40;
+    const std::vector<double> sig = testSignal(8 * bl, 0.05);  // NOLINT
+    const size_t blocks = sig.size() / bl;
+
+    SECTION("steady-state block encoding does not allocate") {
+        for (auto coder : {VC_PWQ::EntropyCoder::ARITHMETIC, VC_PWQ::EntropyCoder::RANGE}) {
+            TestEncoder encoder(bl, fs);
+            encoder.setEntropyCoder(coder);
+            VC_PWQ::ChannelView view = {sig.data(), sig.size(), 1};
+            VC_PWQ::BitWriter bitstream;
+            bitstream.reserve(VC_PWQ::BINARY_RESERVE * blocks);
+
+            encoder.encodeBlocks1D(view, 0, blocks, budget, bitstream);  // warm-up
+            bitstream.clear();
+            CHECK(countAllocations([&]() { encoder.encodeBlocks1D(view, 0, blocks, budget, bitstream); }) == 0);
+        }
+    }
+
+    SECTION("steady-state multichannel block encoding does not allocate") {
+        const std::vector<double> sig2 = testSignal(sig.size(), 0.21);  // NOLINT
+        std::vector<VC_PWQ::ChannelView> views = {{sig.data(), sig.size(), 1}, {sig2.data(), sig2.size(), 1}};
+        TestEncoder encoder(bl, fs);
+        VC_PWQ::BitWriter bitstream;
+        bitstream.reserve(2 * VC_PWQ::BINARY_RESERVE * blocks);
+
+        encoder.encodeBlocksMD(views, 0, blocks, budget, bitstream);  // warm-up
+        bitstream.clear();
+        CHECK(countAllocations([&]() { encoder.encodeBlocksMD(views, 0, blocks, budget, bitstream); }) == 0);
+    }
+
+    SECTION("a reused encoder produces the same stream as a new one") {
+        VC_PWQ::Encoder reused(bl, fs);
+        const std::vector<double> other = testSignal(5 * bl, 0.3);  // NOLINT
+        reused.encode1D(other, budget);
+        VC_PWQ::BitWriter first = reused.encode1D(sig, budget);
+
+        VC_PWQ::Encoder fresh(bl, fs);
+        VC_PWQ::BitWriter second = fresh.encode1D(sig, budget);
+        REQUIRE(first.size() == second.size());
+        CHECK(std::memcmp(first.data(), second.data(), first.sizeBytes()) == 0);
+    }
+}
+
+TEST_CASE("Encoder rate control") {
+
+    static constexpr int bl = 256;
+    static constexpr int fs = 8000;
+    static constexpr int budget = 100;
+    static constexpr int header = 64;  // stream header, fs and channel count
+    const std::vector<double> sig = testSignal(40 * bl, 0.05);  // NOLINT
+    const double seconds = (double)sig.size() / fs;
+
+    SECTION("the stream fits the leaky bucket") {
+        for (double kbps : {8.0, 32.0}) {  // NOLINT
+            const int buffer = (int)(kbps * 250);  // NOLINT
+            VC_PWQ::Encoder encoder(bl, fs);
+            encoder.setRateControl(kbps, buffer);
+            VC_PWQ::BitWriter bitstream = encoder.encode1D(sig, budget);
+            CHECK((double)bitstream.size() <= kbps * 1000 * seconds + buffer + header);
+            CHECK((double)bitstream.size() >= kbps * 1000 * seconds / 2);
+        }
+    }
+
+    SECTION("the rate follows the target") {
+        VC_PWQ::Encoder low(bl, fs);
+        low.setRateControl(8, 2000);  // NOLINT
+        VC_PWQ::Encoder high(bl, fs);
+        high.setRateControl(32, 8000);  // NOLINT
+        CHECK(low.encode1D(sig, budget).size() < high.encode1D(sig, budget).size());
+    }
+
+    SECTION("sliced streams do not depend on the thread count") {
+        VC_PWQ::Encoder single(bl, fs);
+        single.setRateControl(16, 4000);  // NOLINT
+        single.setSlices(8);              // NOLINT
+        VC_PWQ::BitWriter first = single.encode1D(sig, budget);
+
+        VC_PWQ::Encoder threaded(bl, fs);
+        threaded.setRateControl(16, 4000);  // NOLINT
+        threaded.setSlices(8);              // NOLINT
+        threaded.setThreads(4);
+        VC_PWQ::BitWriter second = threaded.encode1D(sig, budget);
+        REQUIRE(first.size() == second.size());
+        CHECK(std::memcmp(first.data(), second.data(), first.sizeBytes()) == 0);
+    }
+}
+
+TEST_CASE("StreamingEncoder") {
+
+    static constexpr int bl = 256;
+    static constexpr int fs = 8000;
+    static constexpr int budget = 40;
+    const std::vector<double> sig = testSignal(9 * bl + 37, 0.05);  // NOLINT
+
+    SECTION("chunked single channel streams match encode1D") {
+        for (auto coder : {VC_PWQ::EntropyCoder::ARITHMETIC, VC_PWQ::EntropyCoder::RANGE}) {
+            for (bool scalable : {false, true}) {
+                VC_PWQ::Encoder reference(bl, fs);
+                reference.setEntropyCoder(coder);
+                reference.setScalable(scalable);
+                VC_PWQ::StreamingEncoder encoder(bl, fs, budget);
+                encoder.setEntropyCoder(coder);
+                encoder.setScalable(scalable);
+                CHECK(sameBytes(streamEncode(encoder, sig, 1), reference.encode1D(sig, budget)));
+            }
+        }
+    }
+
+    SECTION("chunked multichannel streams match encodeMD") {
+        const std::vector<std::vector<double>> channels = {
+            sig, testSignal(sig.size(), 0.21), testSignal(sig.size(), 0.9)};  // NOLINT
+        const std::vector<double> interleaved = interleave(channels);
+        for (auto coder : {VC_PWQ::EntropyCoder::ARITHMETIC, VC_PWQ::EntropyCoder::RANGE}) {
+            VC_PWQ::Encoder reference(bl, fs);
+            reference.setEntropyCoder(coder);
+            VC_PWQ::StreamingEncoder encoder(bl, fs, budget, 3);
+            encoder.setEntropyCoder(coder);
+            CHECK(sameBytes(streamEncode(encoder, interleaved, 3), reference.encodeMD(channels, budget)));
+        }
+    }
+
+    SECTION("a finished encoder starts a new stream") {
+        VC_PWQ::Encoder reference(bl, fs);
+        VC_PWQ::StreamingEncoder encoder(bl, fs, budget);
+        streamEncode(encoder, testSignal(3 * bl, 0.3), 1);  // NOLINT
+        CHECK(sameBytes(streamEncode(encoder, sig, 1), reference.encode1D(sig, budget)));
+    }
+
+    SECTION("steady-state push and read do not allocate") {
+        for (int channels : {1, 3}) {
+            const std::vector<double> interleaved = interleave(std::vector<std::vector<double>>(channels, sig));
+            VC_PWQ::StreamingEncoder encoder(bl, fs, budget, channels);
+            std::vector<uint8_t> bytes(VC_PWQ::BINARY_RESERVE * channels);
+            encoder.push(interleaved.data(), 2 * bl);  // warm-up
+            encoder.read(bytes.data(), bytes.size());
+
+            const double* samples = interleaved.data() + (size_t)2 * bl * channels;
+            CHECK(countAllocations([&]() {
+                      encoder.push(samples, 100);                                    // NOLINT
+                      encoder.push(samples + (size_t)100 * channels, 2 * bl - 100);  // NOLINT
+                      encoder.read(bytes.data(), bytes.size());
+                  }) == 0);
+        }
+    }
+}
@@ -20,6 +20,10 @@
 #include <vector>
 
 #include "../../constants/constants.hpp"
+#include "../../utilities/include/Bitstream.hpp"
+#include "../../utilities/include/Stats.hpp"
+#include "ContextModel.hpp"
+#include "RangeDec.hpp"
 
 namespace VC_PWQ {
 
@@ -30,23 +34,32 @@ class ArithDec {
   public:
     ArithDec();
 
-    void initDecoding(std::vector<char>* instream, size_t pos, size_t length);
+    void initDecoding(const BitReader& bitstream, size_t pos, size_t length);
     auto decode(int context) -> int;
     void resetCounter();
     void rescaleCounter();
 
+    void setCoder(EntropyCoder coder);
+    [[nodiscard]] auto getCoder() const -> EntropyCoder;
+    void setStats(Stats* stats);
+    [[nodiscard]] auto exhausted() const -> bool;
+
   private:
-    std::vector<char>* instream;
-    size_t in_index;
-    size_t max_index;
+    BitReader instream;
 
     int range_diff;
     int range_lower;
     int range_upper;
 
-    std::array<int, CONTEXTS> counter;
-    std::array<int, CONTEXTS> counter_total;
+    ContextModel model;
     int in_leading;
+
+    // range coder backend, used instead of the 10 bit arithmetic coder if selected
+    EntropyCoder coder = EntropyCoder::ARITHMETIC;
+    RangeDec range_coder;
+
+    // optional sink for symbol and renormalization counts
+    Stats* stats = nullptr;
 };
 
 }  // namespace VC_PWQ
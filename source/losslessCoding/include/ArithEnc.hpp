@@ -20,20 +20,54 @@
 #include <vector>
 
 #include "../../constants/constants.hpp"
+#include "../../utilities/include/Bitstream.hpp"
+#include "../../utilities/include/Stats.hpp"
+#include "ContextModel.hpp"
+#include "RangeEnc.hpp"
 
 namespace VC_PWQ {
 
+// zeros written behind a scalable block, so the decoder never reads behind its end; one register of the decoder
+static constexpr int SCALABLE_PAD_BITS = 10;
+
 class ArithEnc {
   public:
     ArithEnc();
 
-    void encode(std::vector<char>* instream, std::vector<int>* context, std::vector<char>* outstream);
+    void encode(BitWriter* instream, std::vector<int>* context, BitWriter* outstream);
     void resetCounter();
     void rescaleCounter();
 
+    void start(BitWriter* outstream);
+    void encodeSymbol(int symbol, int context);
+    void finish();
+
+    void setCoder(EntropyCoder coder);
+    [[nodiscard]] auto getCoder() const -> EntropyCoder;
+    void setStats(Stats* stats);
+    void setScalable(bool scalable);
+
   private:
-    std::array<int, CONTEXTS> counter;
-    std::array<int, CONTEXTS> counter_total;
+    void writeBitPlusFollow(int bit);
+
+    ContextModel model;
+
+    // range coder backend, used instead of the 10 bit arithmetic coder if selected
+    EntropyCoder coder = EntropyCoder::ARITHMETIC;
+    RangeEnc range_coder;
+
+    // optional sink for symbol and renormalization counts
+    Stats* stats = nullptr;
+
+    // keep the stream decodable without reading behind its end, see finish
+    bool scalable = false;
+
+    // state of the running encoding
+    BitWriter* outstream = nullptr;
+    size_t outstream_start = 0;
+    int range_lower = 0;
+    int range_upper = RANGE_MAX;
+    int bits_to_follow = 0;
 };
 
 }  // namespace VC_PWQ
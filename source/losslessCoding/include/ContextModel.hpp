@@ -0,0 +1,75 @@
+//=======================================================================
+/** @file ContextModel.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Adaptive probability model of the arithmetic coder. The probability of a 0 is estimated per context from symbol
+ * counts; all computations are done in integer arithmetic.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef ContextModel_hpp
+#define ContextModel_hpp
+
+#include <array>
+#include <cstddef>
+
+#include "../../constants/constants.hpp"
+
+namespace VC_PWQ {
+
+class ContextModel {
+  public:
+    ContextModel();
+
+    void reset();
+    void rescale();
+
+    [[nodiscard]] auto split(int context, int range_diff) const -> int;
+    void update(int context, int symbol);
+
+  private:
+    std::array<int, CONTEXTS> counter;
+    std::array<int, CONTEXTS> counter_total;
+};
+
+/**
+ * @brief return the width of the subrange for a 0 symbol
+ * @details the probability round(counter / counter_total * RANGE_MAX) is computed as integer fraction, which is exact
+ * for all possible counter values; the subrange is kept at least 1 and at most range_diff - 1 wide
+ * @param context context number
+ * @param range_diff width of the current range
+ * @return width of the subrange
+ */
+inline auto ContextModel::split(int context, int range_diff) const -> int {
+    int c = counter[context];
+    int t = counter_total[context];
+    int p = (2 * RANGE_MAX * c + t) / (2 * t);  // p scaled to full range, rounded
+    int range_add = (range_diff * p) / RANGE_MAX;
+
+    // if p is close to 0 or maximum, value has to be adjusted
+    if (range_add == 0) {
+        range_add = 1;
+    } else if (range_add == range_diff) {
+        range_add = range_diff - 1;
+    }
+    return range_add;
+}
+
+/**
+ * @brief count a coded symbol
+ * @param context context number
+ * @param symbol coded symbol (0 or 1)
+ */
+inline void ContextModel::update(int context, int symbol) {
+    counter[context] += 1 - symbol;
+    counter_total[context]++;
+}
+
+}  // namespace VC_PWQ
+
+#endif /* ContextModel_hpp */
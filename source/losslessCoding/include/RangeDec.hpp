@@ -0,0 +1,51 @@
+//=======================================================================
+/** @file RangeDec.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Binary range decoder with a 32 bit range and bytewise renormalization (LZMA style). Each context has an adaptive
+ * 11 bit probability. Alternative backend of the arithmetic decoder.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef RangeDec_hpp
+#define RangeDec_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "../../constants/constants.hpp"
+#include "../../utilities/include/Bitstream.hpp"
+#include "../../utilities/include/Stats.hpp"
+
+namespace VC_PWQ {
+
+class RangeDec {
+  public:
+    RangeDec();
+
+    void reset();
+    void initDecoding(const BitReader& bitstream, size_t pos, size_t length);
+    auto decode(int context) -> int;
+    void setStats(Stats* stats);
+    [[nodiscard]] auto exhausted() const -> bool;
+
+  private:
+    std::array<uint32_t, CONTEXTS> prob;
+
+    BitReader instream;
+    uint32_t range = 0;
+    uint32_t code = 0;
+
+    // optional sink for renormalization counts
+    Stats* stats = nullptr;
+};
+
+}  // namespace VC_PWQ
+
+#endif /* RangeDec_hpp */
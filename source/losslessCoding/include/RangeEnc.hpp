@@ -0,0 +1,61 @@
+//=======================================================================
+/** @file RangeEnc.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Binary range encoder with a 32 bit range and bytewise renormalization (LZMA style). Each context has an adaptive
+ * 11 bit probability. Alternative backend of the arithmetic encoder.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef RangeEnc_hpp
+#define RangeEnc_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "../../constants/constants.hpp"
+#include "../../utilities/include/Bitstream.hpp"
+#include "../../utilities/include/Stats.hpp"
+
+namespace VC_PWQ {
+
+class RangeEnc {
+  public:
+    RangeEnc();
+
+    void reset();
+    void start(BitWriter* outstream);
+    void encodeSymbol(int symbol, int context);
+    void finish();
+    void setStats(Stats* stats);
+    void setScalable(bool scalable);
+
+  private:
+    void shiftLow();
+
+    std::array<uint32_t, CONTEXTS> prob;
+
+    BitWriter* outstream = nullptr;
+    size_t outstream_start = 0;
+    uint64_t low = 0;
+    uint32_t range = 0;
+    uint8_t cache = 0;
+    uint64_t cache_size = 0;
+    bool first_byte = true;
+
+    // optional sink for renormalization counts
+    Stats* stats = nullptr;
+
+    // keep the zeros at the end, see finish
+    bool scalable = false;
+};
+
+}  // namespace VC_PWQ
+
+#endif /* RangeEnc_hpp */
@@ -15,7 +15,6 @@
 #define SPIHT_Dec_hpp
 
 #include <iostream>
-#include <list>
 #include <vector>
 
 #include "../../constants/constants.hpp"
@@ -29,30 +28,42 @@ class SPIHT_Dec {
   public:
     SPIHT_Dec();
 
-    void decode(std::vector<char>& bitstream,
+    auto decode(const BitReader& bitstream,
                 size_t pos,
                 size_t streamlength,
                 std::vector<int>& out,
                 int origlength,
                 int level,
                 double* wavmax,
-                int* n_real);
+                int* n_real) -> bool;
 
     void resetCounter();
+    void setCoder(EntropyCoder coder);
+    void setStats(Stats* stats);
+    void setScalable(bool scalable);
 
   private:
-    void sortingPass(std::list<int>& LIP,
-                     std::vector<int>& out,
-                     std::list<int>& LSP,
-                     std::list<pixel>& LIS,
-                     int compare);
-    void refinementPass(std::list<int>& LSP, int LSP_idx, int compare, std::vector<int>& out);
+    void sortingPass(std::vector<int>& out, int compare);
+    auto refinementPass(int LSP_idx, int compare, std::vector<int>& out) -> int;
 
     auto getBit(int context) -> int;
     void getBits(std::vector<int>& out, int context);
 
     ArithDec* arithDec;
     int instream_index = 0;
+
+    // scalable streams: decoding stops at the end of the block, which may have been truncated
+    bool scalable = false;
+    bool truncated = false;
+
+    // side information bits; sized in the constructor, so decoding a block does not allocate
+    std::vector<int> maxallocbitsArray;
+    std::vector<int> wavmaxArray;
+
+    // SPIHT lists; kept between blocks to reuse their memory
+    std::vector<int> LIP;
+    std::vector<int> LSP;
+    std::vector<pixel> LIS;
 };
 
 }  // namespace VC_PWQ
@@ -15,12 +15,12 @@
 #define SPIHT_Enc_hpp
 
 #include <iostream>
-#include <list>
 #include <vector>
 
 #include "../../constants/constants.hpp"
 #include "../../utilities/include/Utilities.hpp"
 #include "../../utilities/include/types.hpp"
+#include "ArithEnc.hpp"
 
 namespace VC_PWQ {
 
@@ -28,33 +28,22 @@ class SPIHT_Enc {
   public:
     SPIHT_Enc();
 
-    void encode(std::vector<int>& data,
-                int level,
-                std::vector<char>* bitwavmax,
-                int maxallocbits,
-                std::vector<char>& outstream,
-                std::vector<int>& context);
+    void encode(std::vector<int>& data, int level, BitWriter* bitwavmax, int maxallocbits, ArithEnc& arithmetic);
 
   private:
-    void sortingPass(std::list<int>& LIP,
-                     std::list<int>& LSP,
-                     std::list<pixel>& LIS,
-                     int compare,
-                     std::vector<int>& data,
-                     std::vector<char>& outstream,
-                     std::vector<int>& context);
-    void static refinementPass(std::list<int>& LSP,
-                               int LSP_idx,
-                               std::vector<int>& data,
-                               std::vector<char>& outstream,
-                               std::vector<int>& context,
-                               int n);
+    void sortingPass(int compare, std::vector<int>& data, ArithEnc& arithmetic);
+    void refinementPass(int LSP_idx, std::vector<int>& data, ArithEnc& arithmetic, int n);
 
     auto maxDescendant(pixel p) -> int;
     void initMaxDescendant(std::vector<int>& signal);
 
     std::vector<int> maxDescendants;
     std::vector<int> maxDescendants1;
+
+    // SPIHT lists; kept between blocks to reuse their memory
+    std::vector<int> LIP;
+    std::vector<int> LSP;
+    std::vector<pixel> LIS;
 };
 
 }  // namespace VC_PWQ
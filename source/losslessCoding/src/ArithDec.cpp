@@ -18,34 +18,30 @@ namespace VC_PWQ {
 /**
  * @brief constructor
  */
-ArithDec::ArithDec() {
-    resetCounter();
-}
+ArithDec::ArithDec() {}
 
 /**
  * @brief initialize arithmetic decoder
  * @details the arithmetic decoding is performed for one bit at a time, because the context in SPIHT is only known for
  * the very next bit; this function is called at the beginning of each signal block decoding process
- * @param instream input bitstream
+ * @param bitstream input bitstream
  * @param pos position of first relevant bit
- * @param length length of bistream belonging to the current signal block
+ * @param length length of bistream belonging to the current signal block; bits behind are read as zeros
  */
-void ArithDec::initDecoding(std::vector<char>* instream, size_t pos, size_t length) {
-    this->instream = instream;
-    in_index = pos;
-    max_index = pos + length - 1;
+void ArithDec::initDecoding(const BitReader& bitstream, size_t pos, size_t length) {
+    if (coder == EntropyCoder::RANGE) {
+        range_coder.initDecoding(bitstream, pos, length);
+        return;
+    }
+
+    instream = bitstream.sub(pos, length);
 
     // get first 10 digits
     in_leading = 0;
     int shift = SHIFT;
     for (int i = 0; i < DIGITS_START; i++) {
-        if (i < length) {
-            in_leading += (int)(instream->at(in_index)) << shift;
-            in_index++;
-            shift--;
-        } else {
-            break;
-        }
+        in_leading += instream.readBit() << shift;
+        shift--;
     }
 
     range_diff = RANGE_MAX;
@@ -58,18 +54,13 @@ void ArithDec::initDecoding(std::vector<char>* instream, size_t pos, size_t leng
  * @param context context number for the current bit
  */
 auto ArithDec::decode(int context) -> int {
-
-    double p = round((double)(counter.at(context)) / (double)(counter_total.at(context)) *
-                     RANGE_MAX);  // p scaled to full range
-    int compare = (int)((double)(range_diff)*p) / RANGE_MAX;
-
-    // if p is close to 0 or maximum, value has to be adjusted
-    if (compare == 0) {
-        compare = 1;
-    } else if (compare == range_diff) {
-        compare = range_diff - 1;
+    countSymbol(stats, context);
+    if (coder == EntropyCoder::RANGE) {
+        return range_coder.decode(context);
     }
 
+    int compare = model.split(context, range_diff);
+
     int value = in_leading - range_lower;
 
     // determine decoded symbol; range is updated
@@ -88,42 +79,25 @@ auto ArithDec::decode(int context) -> int {
         if (range_upper <= HALF) {
             range_lower = range_lower << 1;
             range_upper = range_upper << 1;
-            if (in_index <= max_index) {
-                in_leading = (in_leading << 1) + instream->at(in_index);
-                in_index++;
-            } else {
-                in_leading = in_leading << 1;
-            }
+            in_leading = (in_leading << 1) + instream.readBit();
         } else if (range_lower >= HALF) {
             range_lower = (range_lower - HALF) << 1;
             range_upper = (range_upper - HALF) << 1;
-            if (in_index <= max_index) {
-                in_leading = ((in_leading - HALF) << 1) + instream->at(in_index);
-                in_index++;
-            } else {
-                in_leading = (in_leading - HALF) << 1;
-            }
+            in_leading = ((in_leading - HALF) << 1) + instream.readBit();
         } else if (range_lower >= FIRST_QTR && range_upper <= THIRD_QTR) {
             range_lower = (range_lower - FIRST_QTR) << 1;
             range_upper = (range_upper - FIRST_QTR) << 1;
-            if (in_index <= max_index) {
-                in_leading = ((in_leading - FIRST_QTR) << 1) + instream->at(in_index);
-                in_index++;
-            } else {
-                in_leading = (in_leading - FIRST_QTR) << 1;
-            }
+            in_leading = ((in_leading - FIRST_QTR) << 1) + instream.readBit();
         } else {
             break;
         }
+        countRenormalization(stats);
     }
 
     range_diff = range_upper - range_lower;
 
     // update counter for probabilities
-    if (s == 0) {
-        counter.at(context)++;
-    }
-    counter_total.at(context)++;
+    model.update(context, s);
 
     return s;
 }
@@ -132,23 +106,55 @@ auto ArithDec::decode(int context) -> int {
  * @brief reset context counter
  */
 void ArithDec::resetCounter() {
-    for (int i = 0; i < CONTEXTS; i++) {
-        counter.at(i) = RESET / 2;
-        counter_total.at(i) = RESET;
-    }
+    model.reset();
+    range_coder.reset();
 }
 
 /**
  * @brief rescale context counter
+ * @details the range coder adapts with an exponential decay and needs no rescaling
  */
 void ArithDec::rescaleCounter() {
-    for (int i = 0; i < CONTEXTS; i++) {
-        counter.at(i) = (int)((double)counter.at(i) / (double)counter_total.at(i) * RESIZE);
-        if (counter.at(i) == 0) {
-            counter.at(i) = 1;
-        }
-        counter_total.at(i) = RESIZE;
+    model.rescale();
+}
+
+/**
+ * @brief select the entropy coder backend; the probabilities are reset
+ * @param coder entropy coder
+ */
+void ArithDec::setCoder(EntropyCoder coder) {
+    this->coder = coder;
+    resetCounter();
+}
+
+/**
+ * @brief get the selected entropy coder backend
+ * @return entropy coder
+ */
+auto ArithDec::getCoder() const -> EntropyCoder {
+    return coder;
+}
+
+/**
+ * @brief set the sink for the symbol and renormalization counts; only used if the library is built with VC_PWQ_STATS
+ * @param stats statistics to update; nullptr disables counting
+ */
+void ArithDec::setStats(Stats* stats) {
+    this->stats = stats;
+    range_coder.setStats(stats);
+}
+
+/**
+ * @brief check if the decoder has read behind the end of the block
+ * @details the next symbol only depends on the bits read so far; as long as none of them was behind the end, it is
+ * decoded exactly as from the complete stream, also if the stream was truncated
+ * @return true if bits behind the end of the block were read
+ */
+auto ArithDec::exhausted() const -> bool {
+    if (coder == EntropyCoder::RANGE) {
+        return range_coder.exhausted();
     }
+    return instream.position() > instream.size();
 }
 
 }  // namespace VC_PWQ
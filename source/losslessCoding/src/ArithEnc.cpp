@@ -18,9 +18,7 @@ using namespace VC_PWQ;
 /**
  * @brief constructor
  */
-ArithEnc::ArithEnc() {
-    resetCounter();
-}
+ArithEnc::ArithEnc() {}
 
 /**
  * @brief arithmetic encoder
@@ -28,130 +26,185 @@ ArithEnc::ArithEnc() {
  * @param context context bitstream
  * @param outstream output bitstream
  */
-void ArithEnc::encode(std::vector<char>* instream, std::vector<int>* context, std::vector<char>* outstream) {
-
-    // init loop variables
-    int range_lower = 0;
-    int range_upper = RANGE_MAX;
-    int bits_to_follow = 0;
-    int range_diff = 0;
-    int new_symbol = 0;
-    int c = 0;
-    int range_add = 0;
-
-    for (int i = 0; i < instream->size(); i++) {
+void ArithEnc::encode(BitWriter* instream, std::vector<int>* context, BitWriter* outstream) {
+    start(outstream);
+    BitReader symbols(*instream);
+    for (size_t i = 0; i < instream->size(); i++) {
+        encodeSymbol(symbols.readBit(), context->at(i));
+    }
+    finish();
+}
 
-        // calculate range
-        range_diff = range_upper - range_lower;
-        new_symbol = (int)(unsigned char)instream->at(i);
+/**
+ * @brief start encoding a new sequence of symbols
+ * @details the symbols are passed one by one with encodeSymbol, finish completes the encoded stream
+ * @param outstream output bitstream; the encoded bits are appended
+ */
+void ArithEnc::start(BitWriter* outstream) {
+    if (coder == EntropyCoder::RANGE) {
+        range_coder.start(outstream);
+        return;
+    }
+    this->outstream = outstream;
+    outstream_start = outstream->size();
+    range_lower = 0;
+    range_upper = RANGE_MAX;
+    bits_to_follow = 0;
+}
 
-        c = context->at(i);
+/**
+ * @brief encode a single symbol
+ * @param symbol symbol to encode (0 or 1)
+ * @param context context number used for the probability estimation
+ */
+void ArithEnc::encodeSymbol(int symbol, int context) {
+    countSymbol(stats, context);
+    if (coder == EntropyCoder::RANGE) {
+        range_coder.encodeSymbol(symbol, context);
+        return;
+    }
 
-        double p = round((double)counter.at(c) / (double)counter_total.at(c) * RANGE_MAX);  // p scaled to full range
-        range_add = ((int)((double)range_diff * p)) / RANGE_MAX;
+    // calculate range
+    int range_add = model.split(context, range_upper - range_lower);
 
-        // if p is close to 0 or maximum, value has to be adjusted
-        if (range_add == 0) {
-            range_add = 1;
-        } else if (range_add == range_diff) {
-            range_add = range_diff - 1;
-        }
+    if (symbol == 0) {
+        range_upper = range_lower + range_add;
+    } else {
+        range_lower = range_lower + range_add;
+    }
 
-        if (new_symbol == 0) {
-            range_upper = range_lower + range_add;
+    // adjust range to prevent underflow and set output
+    while (true) {
+
+        if (range_upper <= HALF) {
+            writeBitPlusFollow(0);
+        } else if (range_lower >= HALF) {
+            writeBitPlusFollow(1);
+            range_lower -= HALF;
+            range_upper -= HALF;
+        } else if (range_lower >= FIRST_QTR && range_upper <= THIRD_QTR) {
+            bits_to_follow++;
+            range_lower -= FIRST_QTR;
+            range_upper -= FIRST_QTR;
         } else {
-            range_lower = range_lower + range_add;
+            break;
         }
+        range_lower = range_lower << 1;
+        range_upper = range_upper << 1;
+        countRenormalization(stats);
+    }
 
-        // adjust range to prevent underflow and set output
-        while (true) {
-
-            if (range_upper <= HALF) {
-                if (bits_to_follow > 0) {
-                    outstream->push_back(0);
-                    for (int j = 0; j < bits_to_follow; j++) {
-                        outstream->push_back(1);
-                    }
-                    bits_to_follow = 0;
-                } else {
-                    outstream->push_back(0);
-                }
-            } else if (range_lower >= HALF) {
-                if (bits_to_follow > 0) {
-                    outstream->push_back(1);
-                    for (int j = 0; j < bits_to_follow; j++) {
-                        outstream->push_back(0);
-                    }
-                    bits_to_follow = 0;
-                } else {
-                    outstream->push_back(1);
-                }
-                range_lower -= HALF;
-                range_upper -= HALF;
-            } else if (range_lower >= FIRST_QTR && range_upper <= THIRD_QTR) {
-                bits_to_follow++;
-                range_lower -= FIRST_QTR;
-                range_upper -= FIRST_QTR;
-            } else {
-                break;
-            }
-            range_lower = range_lower << 1;
-            range_upper = range_upper << 1;
-        }
+    // update counter for probabilities
+    model.update(context, symbol);
+}
 
-        // update counter for probabilities
-        if (instream->at(i) == 0) {
-            counter.at(c)++;
-        }
-        counter_total.at(c)++;
+/**
+ * @brief complete the encoded stream
+ * @details writes the shortest number in the final range and cuts off the zeros at the end; in scalable mode, the zeros
+ * the decoder reads behind the final number are written instead, so any prefix of the stream can be decoded without
+ * reading behind its end
+ */
+void ArithEnc::finish() {
+    if (coder == EntropyCoder::RANGE) {
+        range_coder.finish();
+        return;
     }
 
     // set remainder to output
     if (bits_to_follow > 0) {
         // if bits_to_follow is not reset to 0, setting the LSB of the output to 1
         // is the shortest encoded number in the correct range
-        outstream->push_back(1);
+        outstream->writeBit(1);
     } else {
         int val = HALF;
         while (range_lower > 0) {
             if (val < range_upper) {
-                outstream->push_back(1);
+                outstream->writeBit(1);
                 range_lower -= val;
                 range_upper -= val;
             } else {
-                outstream->push_back(0);
+                outstream->writeBit(0);
             }
             val = val >> 1;
         }
     }
 
+    if (scalable) {
+        // the pending opposite bits of the final 1 are zeros, too
+        for (int i = 0; i < bits_to_follow + SCALABLE_PAD_BITS; i++) {
+            outstream->writeBit(0);
+        }
+        outstream = nullptr;
+        return;
+    }
+
     // cut off unnecessary zeros at end
-    size_t index_end = outstream->size() - 1;
-    while (outstream->at(index_end) == 0 && index_end >= 0) {
+    size_t index_end = outstream->size();
+    while (index_end > outstream_start && outstream->at(index_end - 1) == 0) {
         index_end--;
     }
-    outstream->resize(index_end + 1);
+    outstream->resize(index_end);
+    outstream = nullptr;
+}
+
+/**
+ * @brief write a bit followed by the pending opposite bits
+ * @param bit bit to write
+ */
+void ArithEnc::writeBitPlusFollow(int bit) {
+    outstream->writeBit(bit);
+    for (; bits_to_follow > 0; bits_to_follow--) {
+        outstream->writeBit(1 - bit);
+    }
 }
 
 /**
  * @brief reset the context counter for probability estimation
  */
 void ArithEnc::resetCounter() {
-    for (int i = 0; i < CONTEXTS; i++) {
-        counter.at(i) = RESET / 2;
-        counter_total.at(i) = RESET;
-    }
+    model.reset();
+    range_coder.reset();
 }
 
 /**
  * @brief rescale the context counter, so new data has more impact on the probability
+ * @details the range coder adapts with an exponential decay and needs no rescaling
  */
 void ArithEnc::rescaleCounter() {
-    for (int i = 0; i < CONTEXTS; i++) {
-        counter.at(i) = (int)((double)counter.at(i) / (double)counter_total.at(i) * RESIZE);
-        if (counter.at(i) == 0) {
-            counter.at(i) = 1;
-        }
-        counter_total.at(i) = RESIZE;
-    }
+    model.rescale();
+}
+
+/**
+ * @brief select the entropy coder backend; the probabilities are reset
+ * @param coder entropy coder
+ */
+void ArithEnc::setCoder(EntropyCoder coder) {
+    this->coder = coder;
+    resetCounter();
+}
+
+/**
+ * @brief get the selected entropy coder backend
+ * @return entropy coder
+ */
+auto ArithEnc::getCoder() const -> EntropyCoder {
+    return coder;
+}
+
+/**
+ * @brief set the sink for the symbol and renormalization counts; only used if the library is built with VC_PWQ_STATS
+ * @param stats statistics to update; nullptr disables counting
+ */
+void ArithEnc::setStats(Stats* stats) {
+    this->stats = stats;
+    range_coder.setStats(stats);
+}
+
+/**
+ * @brief select the termination of scalable streams, see finish
+ * @param scalable true for scalable streams
+ */
+void ArithEnc::setScalable(bool scalable) {
+    this->scalable = scalable;
+    range_coder.setScalable(scalable);
 }
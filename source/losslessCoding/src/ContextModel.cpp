@@ -0,0 +1,50 @@
+//=======================================================================
+/** @file ContextModel.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Adaptive probability model of the arithmetic coder. The probability of a 0 is estimated per context from symbol
+ * counts; all computations are done in integer arithmetic.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/ContextModel.hpp"
+
+namespace VC_PWQ {
+
+/**
+ * @brief constructor
+ */
+ContextModel::ContextModel() {
+    reset();
+}
+
+/**
+ * @brief reset the context counter for probability estimation
+ */
+void ContextModel::reset() {
+    for (size_t i = 0; i < CONTEXTS; i++) {
+        counter[i] = RESET / 2;
+        counter_total[i] = RESET;
+    }
+}
+
+/**
+ * @brief rescale the context counter, so new data has more impact on the probability
+ * @details floor(counter / counter_total * RESIZE), computed as integer fraction
+ */
+void ContextModel::rescale() {
+    for (size_t i = 0; i < CONTEXTS; i++) {
+        counter[i] = (counter[i] * RESIZE) / counter_total[i];
+        if (counter[i] == 0) {
+            counter[i] = 1;
+        }
+        counter_total[i] = RESIZE;
+    }
+}
+
+}  // namespace VC_PWQ
@@ -0,0 +1,90 @@
+//=======================================================================
+/** @file RangeDec.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Binary range decoder with a 32 bit range and bytewise renormalization (LZMA style). Each context has an adaptive
+ * 11 bit probability. Alternative backend of the arithmetic decoder.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/RangeDec.hpp"
+
+namespace VC_PWQ {
+
+/**
+ * @brief constructor
+ */
+RangeDec::RangeDec() {
+    reset();
+}
+
+/**
+ * @brief reset the probabilities of all contexts
+ */
+void RangeDec::reset() {
+    prob.fill(RC_PROB_INIT);
+}
+
+/**
+ * @brief initialize range decoder for a signal block
+ * @param bitstream input bitstream
+ * @param pos position of first relevant bit
+ * @param length length of bistream belonging to the current signal block; bits behind are read as zeros
+ */
+void RangeDec::initDecoding(const BitReader& bitstream, size_t pos, size_t length) {
+    instream = bitstream.sub(pos, length);
+    range = UINT32_MAX;
+    code = 0;
+    for (int i = 0; i < RC_BYTES; i++) {
+        code = (code << BYTE_SIZE) | (uint32_t)instream.read(BYTE_SIZE);
+    }
+}
+
+/**
+ * @brief decode a single symbol and adapt the probability of its context
+ * @param context context number
+ * @return decoded symbol
+ */
+auto RangeDec::decode(int context) -> int {
+    uint32_t& p = prob[context];
+    uint32_t bound = (range >> RC_PROB_BITS) * p;
+    int s = 0;
+    if (code < bound) {
+        range = bound;
+        p += ((1U << RC_PROB_BITS) - p) >> RC_MOVE_BITS;
+    } else {
+        s = 1;
+        code -= bound;
+        range -= bound;
+        p -= p >> RC_MOVE_BITS;
+    }
+    while (range < RC_TOP) {
+        range <<= BYTE_SIZE;
+        code = (code << BYTE_SIZE) | (uint32_t)instream.read(BYTE_SIZE);
+        countRenormalization(stats);
+    }
+    return s;
+}
+
+/**
+ * @brief set the sink for the renormalization counts; only used if the library is built with VC_PWQ_STATS
+ * @param stats statistics to update; nullptr disables counting
+ */
+void RangeDec::setStats(Stats* stats) {
+    this->stats = stats;
+}
+
+/**
+ * @brief check if the decoder has read behind the end of the block
+ * @return true if bytes behind the end of the block were read
+ */
+auto RangeDec::exhausted() const -> bool {
+    return instream.position() > instream.size();
+}
+
+}  // namespace VC_PWQ
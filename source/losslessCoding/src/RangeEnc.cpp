@@ -0,0 +1,145 @@
+//=======================================================================
+/** @file RangeEnc.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Binary range encoder with a 32 bit range and bytewise renormalization (LZMA style). Each context has an adaptive
+ * 11 bit probability. Alternative backend of the arithmetic encoder.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/RangeEnc.hpp"
+
+namespace VC_PWQ {
+
+static constexpr uint32_t LOW_MASK = 0x00FFFFFF;
+static constexpr uint32_t CARRY_LIMIT = 0xFF000000;
+static constexpr uint8_t BYTE_MAX = 0xFF;
+static constexpr int LOW_SHIFT = 24;
+static constexpr int CARRY_SHIFT = 32;
+
+/**
+ * @brief constructor
+ */
+RangeEnc::RangeEnc() {
+    reset();
+}
+
+/**
+ * @brief reset the probabilities of all contexts
+ */
+void RangeEnc::reset() {
+    prob.fill(RC_PROB_INIT);
+}
+
+/**
+ * @brief start encoding a new sequence of symbols
+ * @param outstream output bitstream; the encoded bytes are appended
+ */
+void RangeEnc::start(BitWriter* outstream) {
+    this->outstream = outstream;
+    outstream_start = outstream->size();
+    low = 0;
+    range = UINT32_MAX;
+    cache = 0;
+    cache_size = 1;
+    first_byte = true;
+}
+
+/**
+ * @brief encode a single symbol and adapt the probability of its context
+ * @param symbol symbol to encode (0 or 1)
+ * @param context context number
+ */
+void RangeEnc::encodeSymbol(int symbol, int context) {
+    uint32_t& p = prob[context];
+    uint32_t bound = (range >> RC_PROB_BITS) * p;
+    if (symbol == 0) {
+        range = bound;
+        p += ((1U << RC_PROB_BITS) - p) >> RC_MOVE_BITS;
+    } else {
+        low += bound;
+        range -= bound;
+        p -= p >> RC_MOVE_BITS;
+    }
+    while (range < RC_TOP) {
+        range <<= BYTE_SIZE;
+        shiftLow();
+        countRenormalization(stats);
+    }
+}
+
+/**
+ * @brief complete the encoded stream
+ * @details the value with the most trailing zeros inside the final range is written and the zeros at the end are cut
+ * off, the decoder reads zeros behind the end of the stream; in scalable mode, the zeros are kept, so the decoder reads
+ * exactly the written bytes and any prefix of the stream can be decoded without reading behind its end
+ */
+void RangeEnc::finish() {
+    for (int shift = CARRY_SHIFT; shift > 0; shift--) {
+        uint64_t mask = (1ULL << shift) - 1;
+        uint64_t value = (low + mask) & ~mask;
+        if (value < low + range) {
+            low = value;
+            break;
+        }
+    }
+    for (int i = 0; i <= RC_BYTES; i++) {
+        shiftLow();
+    }
+    if (scalable) {
+        outstream = nullptr;
+        return;
+    }
+
+    size_t index_end = outstream->size();
+    while (index_end > outstream_start && outstream->at(index_end - 1) == 0) {
+        index_end--;
+    }
+    outstream->resize(index_end);
+    outstream = nullptr;
+}
+
+/**
+ * @brief output the top byte of low, delaying bytes of 0xFF until a possible carry is resolved
+ * @details the very first byte is always zero and is not written
+ */
+void RangeEnc::shiftLow() {
+    if ((uint32_t)low < CARRY_LIMIT || (low >> CARRY_SHIFT) != 0) {
+        auto carry = (uint8_t)(low >> CARRY_SHIFT);
+        uint8_t temp = cache;
+        do {
+            if (first_byte) {
+                first_byte = false;
+            } else {
+                outstream->write((uint8_t)(temp + carry), BYTE_SIZE);
+            }
+            temp = BYTE_MAX;
+        } while (--cache_size != 0);
+        cache = (uint8_t)(low >> LOW_SHIFT);
+    }
+    cache_size++;
+    low = (low & LOW_MASK) << BYTE_SIZE;
+}
+
+/**
+ * @brief set the sink for the renormalization counts; only used if the library is built with VC_PWQ_STATS
+ * @param stats statistics to update; nullptr disables counting
+ */
+void RangeEnc::setStats(Stats* stats) {
+    this->stats = stats;
+}
+
+/**
+ * @brief select the termination of scalable streams, see finish
+ * @param scalable true for scalable streams
+ */
+void RangeEnc::setScalable(bool scalable) {
+    this->scalable = scalable;
+}
+
+}  // namespace VC_PWQ
@@ -18,11 +18,16 @@ namespace VC_PWQ {
 /**
  * @brief constructor
  */
-SPIHT_Dec::SPIHT_Dec() : arithDec(new ArithDec()) {}
+SPIHT_Dec::SPIHT_Dec()
+    : arithDec(new ArithDec()), maxallocbitsArray(MAXALLOCBITS_SIZE, 0), wavmaxArray(WAVMAXLENGTH - 1, 0) {}
 
 /**
  * @brief decode a 1D signal block encoded with SPIHT and Arithmetic Coder
- * @details arithmetic coding is also performed, on a bit-by-bit basis
+ * @details arithmetic coding is also performed, on a bit-by-bit basis. In scalable mode, decoding stops at the end of the
+ * block; the coefficients of a truncated block are decoded up to the last complete symbol and the magnitudes of the
+ * significant ones are moved to the middle of their remaining uncertainty interval: coefficients that were significant
+ * before the last bitplane and did not receive its refinement bit are known to twice the threshold, all others to the
+ * threshold.
  * @param bitstream bitstream to decode
  * @param pos position of first bit in stream
  * @param streamlength length of bitream belonging to one block
@@ -31,29 +36,29 @@ SPIHT_Dec::SPIHT_Dec() : arithDec(new ArithDec()) {}
  * @param level dwt decomposition levels
  * @param wavmax maximum wavelet coefficient; used as scaling factor
  * @param n_real decoded number of bitplanes is saved to this pointer
+ * @return false if the block was truncated within the side information; the block is zero then
  */
-void SPIHT_Dec::decode(std::vector<char>& bitstream,
+auto SPIHT_Dec::decode(const BitReader& bitstream,
                        size_t pos,
                        size_t streamlength,
                        std::vector<int>& out,
                        int origlength,
                        int level,
                        double* wavmax,
-                       int* n_real) {
+                       int* n_real) -> bool {
 
-    arithDec->initDecoding(&bitstream, pos, streamlength);
+    arithDec->initDecoding(bitstream, pos, streamlength);
+    truncated = false;
 
     for (int i = 0; i < origlength; i++) {
         out[i] = 0;
     }
 
     // get maxallocBits
-    std::vector<int> maxallocbitsArray(MAXALLOCBITS_SIZE, 0);
     getBits(maxallocbitsArray, CONTEXT_SIDE);
     int maxallocbits = bi2de(maxallocbitsArray);
 
     int mode = getBit(CONTEXT_SIDE);
-    std::vector<int> wavmaxArray(WAVMAXLENGTH - 1, 0);
     getBits(wavmaxArray, CONTEXT_SIDE);
     int temp = bi2de(wavmaxArray);
     if (mode == 0) {
@@ -62,67 +67,94 @@ void SPIHT_Dec::decode(std::vector<char>& bitstream,
         *wavmax = (double)temp * pow(2, -FRACTIONPART_1) + 1;
     }
     *n_real = maxallocbits;
+    if (truncated) {
+        return false;
+    }
 
     // init LIP, LSP, LIS
     int bandsize = 2 << ((int)log2((double)origlength) - level);
-    std::list<int> LIP;
+    LIP.clear();
+    LSP.clear();
+    LIS.clear();
+    LIP.reserve(origlength);
+    LSP.reserve(origlength);
+    LIS.reserve(origlength);
     for (int i = 0; i < bandsize; i++) {
         LIP.push_back(i);
     }
-    std::list<pixel> LIS;
     for (int i = (bandsize / 2); i < bandsize; i++) {
         pixel p = {i, 0};
         LIS.push_back(p);
     }
-    std::list<int> LSP;
 
     int n = maxallocbits;
     while (0 <= n) {
         int compare = 1 << n;  // 2^n
         int LSP_idx = (int)LSP.size();
         // sorting pass
-        sortingPass(LIP, out, LSP, LIS, compare);
+        sortingPass(out, compare);
 
         // refinement pass
-        refinementPass(LSP, LSP_idx, compare, out);
+        int refined = refinementPass(LSP_idx, compare, out);
 
+        if (truncated) {
+            for (int i = 0; i < (int)LSP.size(); i++) {
+                int offset = (i >= refined && i < LSP_idx) ? compare : (compare >> 1);
+                out[LSP[i]] += sgn(out[LSP[i]]) * offset;
+            }
+            break;
+        }
         n--;
     }
 
     arithDec->rescaleCounter();
+    return true;
 }
 
-void SPIHT_Dec::sortingPass(std::list<int>& LIP,
-                            std::vector<int>& out,
-                            std::list<int>& LSP,
-                            std::list<pixel>& LIS,
-                            int compare) {
-    for (auto it = LIP.begin(); it != LIP.end();) {
+/**
+ * @brief sorting pass of one bitplane
+ * @details LIP and LIS are compacted in place: entries that stay in the list are moved to the front, entries appended
+ * during the pass are processed in the same pass like in a linked list
+ * @param out decoded signal
+ * @param compare threshold of the bitplane
+ */
+void SPIHT_Dec::sortingPass(std::vector<int>& out, int compare) {
+    size_t keep = 0;
+    for (size_t i = 0; i < LIP.size() && !truncated; i++) {
+        int index = LIP[i];
         if (getBit(CONTEXT_SIGNIFICANCE_0) == 1) {
-            if (getBit(CONTEXT_SIGN) == 1) {
-                out[*it] = compare;
+            int sign = getBit(CONTEXT_SIGN);
+            if (truncated) {
+                return;
+            }
+            if (sign == 1) {
+                out[index] = compare;
             } else {
-                out[*it] = -compare;
+                out[index] = -compare;
             }
-            LSP.push_back(*it);
-            it = LIP.erase(it);
+            LSP.push_back(index);
         } else {
-            it++;
+            LIP[keep++] = index;
         }
     }
+    LIP.resize(keep);
 
-    auto it1 = LIS.begin();
-    int LISsize = (int)LIS.size();
-    for (int i = 0; i < LISsize; i++) {
+    keep = 0;
+    for (size_t i = 0; i < LIS.size() && !truncated; i++) {
+        pixel entry = LIS[i];
         // If type A
-        if ((*it1).type == 0) {
+        if (entry.type == 0) {
             if (getBit(CONTEXT_SIGNIFICANCE_1) == 1) {
-                int y = (*it1).index;
+                int y = entry.index;
                 // Children
                 int index = 2 * y;
                 if (getBit(CONTEXT_SIGNIFICANCE_2) == 1) {
+                    int sign = getBit(CONTEXT_SIGN);
+                    if (truncated) {
+                        return;
+                    }
                     LSP.push_back(index);
-                    if (getBit(CONTEXT_SIGN) == 1) {
+                    if (sign == 1) {
                         out[index] = compare;
                     } else {
                         out[index] = -compare;
@@ -133,8 +165,12 @@ void SPIHT_Dec::sortingPass(std::list<int>& LIP,
 
                 index = 2 * y + 1;
                 if (getBit(CONTEXT_SIGNIFICANCE_2) == 1) {
+                    int sign = getBit(CONTEXT_SIGN);
+                    if (truncated) {
+                        return;
+                    }
                     LSP.push_back(index);
-                    if (getBit(CONTEXT_SIGN) == 1) {
+                    if (sign == 1) {
                         out[index] = compare;
                     } else {
                         out[index] = -compare;
@@ -145,49 +181,61 @@ void SPIHT_Dec::sortingPass(std::list<int>& LIP,
 
                 // Grandchildren
                 if ((4 * y + 3) < out.size()) {
-                    pixel p = {(*it1).index, 1};
+                    pixel p = {entry.index, 1};
                     LIS.push_back(p);
-                    LISsize++;
                 }
-                it1 = LIS.erase(it1);
             } else {
-                it1++;
+                LIS[keep++] = entry;
             }
 
             // type B
         } else {
             if (getBit(CONTEXT_SIGNIFICANCE_3) == 1) {
-                int y = (*it1).index;
+                int y = entry.index;
                 pixel p = {2 * y, 0};
                 LIS.push_back(p);
                 p = {2 * y + 1, 0};
                 LIS.push_back(p);
-                LISsize += 2;
-                it1 = LIS.erase(it1);
             } else {
-                it1++;
+                LIS[keep++] = entry;
             }
         }
     }
+    LIS.resize(keep);
 }
 
-void SPIHT_Dec::refinementPass(std::list<int>& LSP, const int LSP_idx, const int compare, std::vector<int>& out) {
-    auto it = LSP.begin();
-    int temp = 0;
-    while (temp < LSP_idx) {
-        if (getBit(CONTEXT_REFINEMENT) == 1) {
-            out[*it] += sgn(out[*it]) * compare;
+/**
+ * @brief refinement pass of one bitplane
+ * @param LSP_idx number of entries of the LSP that were significant before the sorting pass
+ * @param compare threshold of the bitplane
+ * @param out decoded signal
+ * @return number of entries that received their refinement bit; less than LSP_idx if the block is truncated
+ */
+auto SPIHT_Dec::refinementPass(const int LSP_idx, const int compare, std::vector<int>& out) -> int {
+    int refined = 0;
+    for (; refined < LSP_idx && !truncated; refined++) {
+        int bit = getBit(CONTEXT_REFINEMENT);
+        if (truncated) {
+            break;
+        }
+        if (bit == 1) {
+            out[LSP[refined]] += sgn(out[LSP[refined]]) * compare;
         }
-        temp++;
-        it++;
     }
+    return refined;
 }
 
 /**
  * @brief interface function to arithmetic decoder; decodes a single bit for SPIHT
+ * @details in scalable mode, 0 is returned and the block is marked as truncated, if the bit is behind the end of the
+ * block
  * @param context context number of bit to decode; defined by SPIHT
  */
 auto SPIHT_Dec::getBit(int context) -> int {
+    if (scalable && arithDec->exhausted()) {
+        truncated = true;
+        return 0;
+    }
     int temp = arithDec->decode(context);
     return temp;
 }
@@ -200,7 +248,7 @@ auto SPIHT_Dec::getBit(int context) -> int {
  */
 void SPIHT_Dec::getBits(std::vector<int>& out, int context) {
     for (auto& o : out) {
-        o = arithDec->decode(context);
+        o = getBit(context);
     }
 }
 
@@ -208,4 +256,28 @@ void SPIHT_Dec::resetCounter() {
     arithDec->resetCounter();
 }
 
+/**
+ * @brief select the entropy coder backend signalled in the stream header
+ * @param coder entropy coder
+ */
+void SPIHT_Dec::setCoder(EntropyCoder coder) {
+    arithDec->setCoder(coder);
+}
+
+/**
+ * @brief set the sink for the counters of the entropy decoder
+ * @param stats statistics to update; nullptr disables counting
+ */
+void SPIHT_Dec::setStats(Stats* stats) {
+    arithDec->setStats(stats);
+}
+
+/**
+ * @brief select scalable decoding: decoding stops at the end of a block instead of reading zeros behind it
+ * @param scalable true for scalable streams
+ */
+void SPIHT_Dec::setScalable(bool scalable) {
+    this->scalable = scalable;
+}
+
 }  // namespace VC_PWQ
@@ -4,7 +4,7 @@
  *
  * This file is part of the 'VC-PWQ' library
  *
- * The SPIHT encoder. Unlike the decoder, arithmetic encoding is not performed, but has to be done separately.
+ * The SPIHT encoder. Like the decoder, arithmetic coding is performed symbol by symbol.
  *
  * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
  *
@@ -26,41 +26,40 @@ SPIHT_Enc::SPIHT_Enc() {}
  * @param level dwt decomposition levels
  * @param bitwavmax already encoded maximum wavelet coefficient
  * @param maxallocbits highest bit depth in quantized signal; defines number of bitplanes in SPIHT
- * @param outstream output bitstream
- * @param context stream of context numbers for arithmetic encoder
+ * @param arithmetic arithmetic encoder the symbols are passed to; encoding has to be started by the caller
  */
-void SPIHT_Enc::encode(std::vector<int>& data,
-                       int level,
-                       std::vector<char>* bitwavmax,
-                       int maxallocbits,
-                       std::vector<char>& outstream,
-                       std::vector<int>& context) {
+void SPIHT_Enc::encode(
+    std::vector<int>& data, int level, BitWriter* bitwavmax, int maxallocbits, ArithEnc& arithmetic) {
 
     // add maxallocbits to stream
     if (maxallocbits > pow(2, MAXALLOCBITS_SIZE) - 1) {
         std::cerr << "SPIHT: too many bits allocated: " << maxallocbits << std::endl;
         maxallocbits = 15;
     }
-    de2bi(maxallocbits, &outstream, MAXALLOCBITS_SIZE);
+    for (size_t i = 0; i < MAXALLOCBITS_SIZE; i++) {
+        arithmetic.encodeSymbol((maxallocbits >> i) & 1, CONTEXT_SIDE);
+    }
     // add bitwavmax to stream
-    outstream.insert(outstream.end(), bitwavmax->begin(), bitwavmax->end());
-
-    // context
-    std::vector<int> c(MAXALLOCBITS_SIZE + bitwavmax->size(), CONTEXT_SIDE);
-    context.insert(context.end(), c.begin(), c.end());
+    BitReader wavmax(*bitwavmax);
+    for (size_t i = 0; i < bitwavmax->size(); i++) {
+        arithmetic.encodeSymbol(wavmax.readBit(), CONTEXT_SIDE);
+    }
 
     // init LIP, LSP, LIS
     int bandsize = 2 << ((int)log2((double)data.size()) - level);
-    std::list<int> LIP;
+    LIP.clear();
+    LSP.clear();
+    LIS.clear();
+    LIP.reserve(data.size());
+    LSP.reserve(data.size());
+    LIS.reserve(data.size());
     for (int i = 0; i < bandsize; i++) {
         LIP.push_back(i);
     }
-    std::list<pixel> LIS;
     for (int i = (bandsize / 2); i < bandsize; i++) {
         pixel p = {i, 0};
         LIS.push_back(p);
     }
-    std::list<int> LSP;
 
     initMaxDescendant(data);
 
@@ -69,124 +68,108 @@ void SPIHT_Enc::encode(std::vector<int>& data,
         int compare = 1 << n;  // 2^n
         int LSP_idx = (int)LSP.size();
         // sorting pass
-        sortingPass(LIP, LSP, LIS, compare, data, outstream, context);
+        sortingPass(compare, data, arithmetic);
 
         // refinement pass
-        refinementPass(LSP, LSP_idx, data, outstream, context, n);
+        refinementPass(LSP_idx, data, arithmetic, n);
         n--;
     }
 }
 
-void SPIHT_Enc::sortingPass(std::list<int>& LIP,
-                            std::list<int>& LSP,
-                            std::list<pixel>& LIS,
-                            const int compare,
-                            std::vector<int>& data,
-                            std::vector<char>& outstream,
-                            std::vector<int>& context) {
-
-    for (auto it = LIP.begin(); it != LIP.end();) {
-        if (std::abs(data[*it]) >= compare) {
-            outstream.push_back(1);
-            context.push_back(CONTEXT_SIGNIFICANCE_0);
-            outstream.push_back((char)(data[*it] >= 0));
-            context.push_back(CONTEXT_SIGN);
-            LSP.push_back(*it);
-            it = LIP.erase(it);
+/**
+ * @brief sorting pass of one bitplane
+ * @details LIP and LIS are compacted in place: entries that stay in the list are moved to the front, entries appended
+ * during the pass are processed in the same pass like in a linked list
+ * @param compare threshold of the bitplane
+ * @param data quantized values
+ * @param arithmetic arithmetic encoder
+ */
+void SPIHT_Enc::sortingPass(const int compare, std::vector<int>& data, ArithEnc& arithmetic) {
+
+    size_t keep = 0;
+    for (size_t i = 0; i < LIP.size(); i++) {
+        int index = LIP[i];
+        if (std::abs(data[index]) >= compare) {
+            arithmetic.encodeSymbol(1, CONTEXT_SIGNIFICANCE_0);
+            arithmetic.encodeSymbol((int)(data[index] >= 0), CONTEXT_SIGN);
+            LSP.push_back(index);
         } else {
-            outstream.push_back(0);
-            context.push_back(CONTEXT_SIGNIFICANCE_0);
-            it++;
+            arithmetic.encodeSymbol(0, CONTEXT_SIGNIFICANCE_0);
+            LIP[keep++] = index;
         }
     }
+    LIP.resize(keep);
 
-    auto it1 = LIS.begin();
-    int LISsize = (int)LIS.size();
-    for (int i = 0; i < LISsize; i++) {
+    keep = 0;
+    for (size_t i = 0; i < LIS.size(); i++) {
+        pixel entry = LIS[i];
         // If type A
-        if ((*it1).type == 0) {
-            int max_d = maxDescendant(*it1);
+        if (entry.type == 0) {
+            int max_d = maxDescendant(entry);
             if (max_d >= compare) {
-                outstream.push_back(1);
-                context.push_back(CONTEXT_SIGNIFICANCE_1);
-                int y = (*it1).index;
+                arithmetic.encodeSymbol(1, CONTEXT_SIGNIFICANCE_1);
+                int y = entry.index;
                 // Children
                 int index = 2 * y;
                 if (std::abs(data[index]) >= compare) {
                     LSP.push_back(index);
-                    outstream.push_back(1);
-                    context.push_back(CONTEXT_SIGNIFICANCE_2);
-                    outstream.push_back(data[index] >= 0);
-                    context.push_back(CONTEXT_SIGN);
+                    arithmetic.encodeSymbol(1, CONTEXT_SIGNIFICANCE_2);
+                    arithmetic.encodeSymbol((int)(data[index] >= 0), CONTEXT_SIGN);
                 } else {
-                    outstream.push_back(0);
-                    context.push_back(CONTEXT_SIGNIFICANCE_2);
+                    arithmetic.encodeSymbol(0, CONTEXT_SIGNIFICANCE_2);
                     LIP.push_back(index);
                 }
 
                 index = 2 * y + 1;
                 if (std::abs(data[index]) >= compare) {
                     LSP.push_back(index);
-                    outstream.push_back(1);
-                    context.push_back(CONTEXT_SIGNIFICANCE_2);
-                    outstream.push_back(data[index] >= 0);
-                    context.push_back(CONTEXT_SIGN);
+                    arithmetic.encodeSymbol(1, CONTEXT_SIGNIFICANCE_2);
+                    arithmetic.encodeSymbol((int)(data[index] >= 0), CONTEXT_SIGN);
                 } else {
-                    outstream.push_back(0);
-                    context.push_back(CONTEXT_SIGNIFICANCE_2);
+                    arithmetic.encodeSymbol(0, CONTEXT_SIGNIFICANCE_2);
                     LIP.push_back(index);
                 }
 
                 // Grandchildren
                 if ((4 * y + 3) < data.size()) {
-                    pixel p = {(*it1).index, 1};
+                    pixel p = {entry.index, 1};
                     LIS.push_back(p);
-                    LISsize++;
                 }
-                it1 = LIS.erase(it1);
             } else {
-                outstream.push_back(0);
-                context.push_back(CONTEXT_SIGNIFICANCE_1);
-                it1++;
+                arithmetic.encodeSymbol(0, CONTEXT_SIGNIFICANCE_1);
+                LIS[keep++] = entry;
             }
 
             // type B
         } else {
-            int max_d = maxDescendant(*it1);
+            int max_d = maxDescendant(entry);
             if (max_d >= compare) {
-                outstream.push_back(1);
-                context.push_back(CONTEXT_SIGNIFICANCE_3);
-                int y = (*it1).index;
+                arithmetic.encodeSymbol(1, CONTEXT_SIGNIFICANCE_3);
+                int y = entry.index;
                 pixel p = {2 * y, 0};
                 LIS.push_back(p);
                 p = {2 * y + 1, 0};
                 LIS.push_back(p);
-                LISsize += 2;
-                it1 = LIS.erase(it1);
             } else {
-                outstream.push_back(0);
-                context.push_back(CONTEXT_SIGNIFICANCE_3);
-                it1++;
+                arithmetic.encodeSymbol(0, CONTEXT_SIGNIFICANCE_3);
+                LIS[keep++] = entry;
             }
         }
     }
+    LIS.resize(keep);
 }
 
-void SPIHT_Enc::refinementPass(std::list<int>& LSP,
-                               const int LSP_idx,
-                               std::vector<int>& data,
-                               std::vector<char>& outstream,
-                               std::vector<int>& context,
-                               const int n) {
-    auto it = LSP.begin();
-    int temp = 0;
-    while (temp < LSP_idx) {
-
-        int s = bitget((int)floor(std::abs(data[*it])), n + 1);
-        outstream.push_back(s);
-        context.push_back(CONTEXT_REFINEMENT);
-        temp++;
-        it++;
+/**
+ * @brief refinement pass of one bitplane
+ * @param LSP_idx number of entries of the LSP that were significant before the sorting pass
+ * @param data quantized values
+ * @param arithmetic arithmetic encoder
+ * @param n bitplane
+ */
+void SPIHT_Enc::refinementPass(const int LSP_idx, std::vector<int>& data, ArithEnc& arithmetic, const int n) {
+    for (int i = 0; i < LSP_idx; i++) {
+        int s = bitget((int)floor(std::abs(data[LSP[i]])), n + 1);
+        arithmetic.encodeSymbol(s, CONTEXT_REFINEMENT);
     }
 }
 
@@ -0,0 +1,95 @@
+//=======================================================================
+/** @file SPIHT.test.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/ArithEnc.hpp"
+#include "../include/SPIHT_Dec.hpp"
+#include "../include/SPIHT_Enc.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+
+/**
+ * @brief true if the reconstruction is the midpoint of a dyadic interval containing the coefficient
+ * @details the magnitude of a coefficient decoded down to a bitplane of width w is known to be within
+ * [|value| & ~(w - 1), (|value| & ~(w - 1)) + w); w = 1 for a coefficient decoded completely
+ */
+auto isIntervalMidpoint(int value, int reconstruction) -> bool {
+    if (reconstruction == 0) {
+        return true;  // not significant yet
+    }
+    if ((value > 0) != (reconstruction > 0)) {
+        return false;
+    }
+    int magnitude = std::abs(value);
+    for (int width = 1; width <= (magnitude << 1); width <<= 1) {
+        if (std::abs(reconstruction) == (magnitude & ~(width - 1)) + (width >> 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST_CASE("SPIHT") {
+
+    static constexpr int bl = 256;
+    static constexpr int level = 6;  // log2(bl) - 2
+    static constexpr int maxallocbits = 10;
+
+    std::vector<int> data(bl);
+    unsigned state = 1;
+    for (int i = 0; i < bl; i++) {
+        state = state * 1103515245U + 12345U;                        // NOLINT
+        int range = 2048 >> (i / 32);                                // NOLINT
+        data[i] = (int)((state >> 8) % (2 * range - 1)) - range + 1;  // NOLINT
+    }
+
+    SECTION("truncated scalable blocks are reconstructed in the middle of the remaining interval") {
+        for (auto coder : {VC_PWQ::EntropyCoder::ARITHMETIC, VC_PWQ::EntropyCoder::RANGE}) {
+            std::vector<int> input = data;
+            VC_PWQ::BitWriter bitwavmax;
+            bitwavmax.write(0, VC_PWQ::WAVMAXLENGTH);
+            VC_PWQ::BitWriter stream;
+            VC_PWQ::ArithEnc arithmetic;
+            arithmetic.setCoder(coder);
+            arithmetic.setScalable(true);
+            arithmetic.start(&stream);
+            VC_PWQ::SPIHT_Enc encoder;
+            encoder.encode(input, level, &bitwavmax, maxallocbits, arithmetic);
+            arithmetic.finish();
+
+            VC_PWQ::BitReader bitstream(stream);
+            std::vector<int> out(bl);
+            for (size_t bytes = 1; bytes <= stream.sizeBytes(); bytes++) {
+                VC_PWQ::SPIHT_Dec decoder;
+                decoder.setCoder(coder);
+                decoder.setScalable(true);
+                double wavmax = 0;
+                int bitmax = 0;
+                size_t length = std::min(bytes * VC_PWQ::BYTE_SIZE, stream.size());
+                if (!decoder.decode(bitstream, 0, length, out, bl, level, &wavmax, &bitmax)) {
+                    continue;  // truncated within the side information
+                }
+                int mismatches = 0;
+                for (int i = 0; i < bl; i++) {
+                    mismatches += isIntervalMidpoint(data[i], out[i]) ? 0 : 1;
+                }
+                CHECK(mismatches == 0);
+            }
+            CHECK(out == data);
+        }
+    }
+}
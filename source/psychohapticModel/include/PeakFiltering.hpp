@@ -29,10 +29,32 @@ struct peak {
 
 static constexpr double PEAK_HUGE_VAL = 2147483647;  // 2^32 - 1
 
+// intermediate peak lists of FindPeaks, kept between calls
+struct PeakScratch {
+    std::vector<peak> all;
+    std::vector<peak> min_height;
+    std::vector<peak> prominences;
+    std::vector<peak> min_prominence;
+    std::vector<int> valley_left;
+    std::vector<int> valley_right;
+};
+
 auto FindAllPeakLocations(std::vector<double>& x) -> std::vector<peak>;
+void FindAllPeakLocations(std::vector<double>& x, std::vector<peak>& peaks);
 auto PeakProminence(std::vector<double>& spectrum, std::vector<peak>& peaks) -> std::vector<peak>;
+void PeakProminence(std::vector<double>& spectrum,
+                    std::vector<peak>& peaks,
+                    std::vector<peak>& prominences,
+                    std::vector<int>& valley_left,
+                    std::vector<int>& valley_right);
 auto FilterPeakCriterion(std::vector<peak>& input, double min_peak_val) -> std::vector<peak>;
+void FilterPeakCriterion(std::vector<peak>& input, double min_peak_val, std::vector<peak>& result);
 auto FindPeaks(std::vector<double>& spectrum, double min_peak_prominence, double min_peak_height) -> std::vector<peak>;
+void FindPeaks(std::vector<double>& spectrum,
+               double min_peak_prominence,
+               double min_peak_height,
+               PeakScratch& scratch,
+               std::vector<peak>& out);
 
 }  // namespace VC_PWQ::PeakFiltering
 
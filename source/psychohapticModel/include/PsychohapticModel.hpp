@@ -16,6 +16,7 @@
 
 #include <cmath>
 #include <complex>
+#include <string>
 #include <vector>
 
 #include <fftw3.h>
@@ -44,8 +45,11 @@ static constexpr double FACTOR_LOG_2 = 20;
 static constexpr int MAX_BITS = 15;
 
 using PeakFiltering::FindPeaks;
+using PeakFiltering::PeakScratch;
 using PeakFiltering::peak;
 
+enum class PlanningMode { ESTIMATE, MEASURE, PATIENT };
+
 struct pmResult {
     pmResult(int size) : SMR(size, 0), bandenergy(size, 0) {}
     std::vector<double> SMR;
@@ -56,21 +60,41 @@ class PsychohapticModel {
 
   public:
     PsychohapticModel();
+    ~PsychohapticModel();
+    PsychohapticModel(const PsychohapticModel&) = delete;
+    auto operator=(const PsychohapticModel&) -> PsychohapticModel& = delete;
+    PsychohapticModel(PsychohapticModel&& other) noexcept;
+    auto operator=(PsychohapticModel&& other) noexcept -> PsychohapticModel&;
 
-    void init(int bl, int fs);
+    void init(int bl, int fs, PlanningMode mode = PlanningMode::ESTIMATE);
 
     auto getSMR(std::vector<double>& block) -> pmResult;
+    void getSMR(const std::vector<double>& block, std::vector<double>& SMR, std::vector<double>& bandenergy);
     void getSMR_MD(std::vector<std::vector<double>>* block,
                    std::vector<std::vector<double>>& SMR,
                    std::vector<std::vector<double>>& bandenergy);
+    void getSMR_Batch(const std::vector<double>& blocks,
+                      int channels,
+                      std::vector<std::vector<double>>& SMR,
+                      std::vector<std::vector<double>>& bandenergy);
 
     static auto DCT(std::vector<double>& data) -> std::vector<double>;
 
+    static auto importWisdom(const std::string& filename) -> bool;
+    static auto exportWisdom(const std::string& filename) -> bool;
+
   private:
+    void blockDCT(const std::vector<double>& block, std::vector<double>& spect);
+    static void logSpectrum(const double* dct, int size, std::vector<double>& spect);
+    void bandAnalysis(std::vector<double>& spect, double* SMR, double* bandenergy);
+    void planBatch(int channels);
+    static auto plannerFlags(PlanningMode mode) -> unsigned;
+    void destroyPlan();
+
     void globalMaskingThreshold(std::vector<double>& spect, std::vector<double>& globalmask);
     void perceptualThreshold();
 
-    auto PeakMask(std::vector<peak>& peaks) -> std::vector<double>;
+    void PeakMask(std::vector<peak>& peaks, std::vector<double>& mask);
 
     void setFreqVector(int fs, size_t bl);
 
@@ -81,6 +105,24 @@ class PsychohapticModel {
     int fs;
     std::vector<double> freqs;
     std::vector<double> percthres;
+
+    fftw_plan dct_plan = nullptr;
+    double* dct_in = nullptr;
+    double* dct_out = nullptr;
+    unsigned planner_flags = FFTW_ESTIMATE;
+
+    fftw_plan batch_plan = nullptr;
+    double* batch_in = nullptr;
+    double* batch_out = nullptr;
+    int batch_channels = 0;
+
+    // per-block scratch, reused so the analysis of a block does not allocate; not moved with the model
+    std::vector<double> spect;
+    std::vector<double> globalmask;
+    std::vector<double> maskenergy;
+    std::vector<double> mask;
+    std::vector<peak> peaks;
+    PeakScratch peak_scratch;
 };
 
 }  // namespace VC_PWQ
@@ -24,8 +24,19 @@ namespace VC_PWQ::PeakFiltering {
  * @param height     return vector for peak heights
  */
 auto FindAllPeakLocations(std::vector<double>& x) -> std::vector<peak> {
-    // No more than half of the samples can be peaks
     std::vector<peak> peaks;
+    FindAllPeakLocations(x, peaks);
+    return peaks;
+}
+
+/**
+ * @brief Compute the locations of all peaks in a signal x, see above
+ * @param x     signal
+ * @param peaks     return vector for the peaks; its memory is reused
+ */
+void FindAllPeakLocations(std::vector<double>& x, std::vector<peak>& peaks) {
+    // No more than half of the samples can be peaks
+    peaks.clear();
     peaks.reserve(x.size() / 2);
     size_t num_peaks = 0;
     // Last and first sample can't be maxima
@@ -60,7 +71,6 @@ auto FindAllPeakLocations(std::vector<double>& x) -> std::vector<peak> {
     }
     // Result can have less than x->length/2 peaks
     peaks.resize(num_peaks);
-    return peaks;
 }
 
 /**
@@ -75,7 +85,27 @@ auto FindAllPeakLocations(std::vector<double>& x) -> std::vector<peak> {
  */
 auto PeakProminence(std::vector<double>& spectrum, std::vector<peak>& peaks) -> std::vector<peak> {
     std::vector<peak> prominences;
+    std::vector<int> valley_left;
+    std::vector<int> valley_right;
+    PeakProminence(spectrum, peaks, prominences, valley_left, valley_right);
+    return prominences;
+}
+
+/**
+ * @brief Return the topographic prominence in the spectrum of all input peaks, see above
+ * @param spectrum spectrum of signal input
+ * @param peaks already computed peaks
+ * @param prominences output vector; its memory is reused
+ * @param valley_left scratch for the valley locations to the left
+ * @param valley_right scratch for the valley locations to the right
+ */
+void PeakProminence(std::vector<double>& spectrum,
+                    std::vector<peak>& peaks,
+                    std::vector<peak>& prominences,
+                    std::vector<int>& valley_left,
+                    std::vector<int>& valley_right) {
     size_t num_peaks = peaks.size();
+    prominences.clear();
     prominences.reserve(num_peaks);
     // init values
     for (size_t i = 0; i < num_peaks; i++) {
@@ -83,8 +113,8 @@ auto PeakProminence(std::vector<double>& spectrum, std::vector<peak>& peaks) ->
         prominences.push_back(p);
     }
     // Determine location of local minima to each side of a peak
-    std::vector<int> valley_left(num_peaks, 0);  // init with 0 okay?
-    std::vector<int> valley_right(num_peaks, 0);
+    valley_left.assign(num_peaks, 0);  // init with 0 okay?
+    valley_right.assign(num_peaks, 0);
     // valley_right.reserve(num_peaks);
     for (size_t i = 0; i < num_peaks; ++i) {
         // Seek next larger peak or edge of spectrum to the left
@@ -160,7 +190,6 @@ auto PeakProminence(std::vector<double>& spectrum, std::vector<peak>& peaks) ->
         }
         prominences.at(i).height = peaks.at(i).height - Max(valley_left_height_cur, valley_right_height_cur);
     }
-    return prominences;
 }
 
 /**
@@ -173,6 +202,18 @@ auto PeakProminence(std::vector<double>& spectrum, std::vector<peak>& peaks) ->
  */
 auto FilterPeakCriterion(std::vector<peak>& input, double min_peak_val) -> std::vector<peak> {
     std::vector<peak> result;
+    FilterPeakCriterion(input, min_peak_val, result);
+    return result;
+}
+
+/**
+ * @brief Sort out peaks with height below min_peak_val
+ * @param input  peaks, input
+ * @param min_peak_val   minimum value for peaks
+ * @param result   peaks, output; its memory is reused
+ */
+void FilterPeakCriterion(std::vector<peak>& input, double min_peak_val, std::vector<peak>& result) {
+    result.clear();
     size_t length = input.size();
     result.reserve(length);
     size_t num_peaks = 0;
@@ -184,7 +225,6 @@ auto FilterPeakCriterion(std::vector<peak>& input, double min_peak_val) -> std::
         }
     }
     result.resize(num_peaks);
-    return result;
 }
 
 /**
@@ -196,35 +236,54 @@ auto FilterPeakCriterion(std::vector<peak>& input, double min_peak_val) -> std::
  * @param result_location   output vector for peak location
  */
 auto FindPeaks(std::vector<double>& spectrum, double min_peak_prominence, double min_peak_height) -> std::vector<peak> {
-
     std::vector<peak> out;
+    PeakScratch scratch;
+    FindPeaks(spectrum, min_peak_prominence, min_peak_height, scratch, out);
+    return out;
+}
 
-    std::vector<peak> peaks_all = FindAllPeakLocations(spectrum);
+/**
+ * @brief Compute the locations of all peaks in a signal x and reduce to most prominent ones
+ * @details intermediate results are kept in the scratch, so repeated calls do not allocate once the vectors have grown
+ * @param spectrum  signal spectrum
+ * @param min_peak_prominence   minimum prominence of detected peaks
+ * @param min_peak_height   minimum height of detected peaks
+ * @param scratch   intermediate peak lists
+ * @param out   output vector for the peaks; its memory is reused
+ */
+void FindPeaks(std::vector<double>& spectrum,
+               double min_peak_prominence,
+               double min_peak_height,
+               PeakScratch& scratch,
+               std::vector<peak>& out) {
+
+    out.clear();
 
-    if (peaks_all.empty()) {
+    FindAllPeakLocations(spectrum, scratch.all);
+
+    if (scratch.all.empty()) {
         // printf("\nNo peaks were found!\n");
-        return peaks_all;
+        return;
     }
     // TODO Filter peak height before or after peak prominence detection?
-    std::vector<peak> peaks_min_h = FilterPeakCriterion(peaks_all, min_peak_height);
+    FilterPeakCriterion(scratch.all, min_peak_height, scratch.min_height);
 
-    if (peaks_min_h.empty()) {
+    if (scratch.min_height.empty()) {
         // printf("\nNo peaks were found after filtering for minimum height!\n");
-        return peaks_min_h;
+        return;
     }
-    std::vector<peak> prominences = PeakProminence(spectrum, peaks_min_h);
+    PeakProminence(spectrum, scratch.min_height, scratch.prominences, scratch.valley_left, scratch.valley_right);
 
-    std::vector<peak> peaks_min_prominence = FilterPeakCriterion(prominences, min_peak_prominence);
+    FilterPeakCriterion(scratch.prominences, min_peak_prominence, scratch.min_prominence);
 
     // Save heights instead of prominences
-    size_t prominences_length = peaks_min_prominence.size();
+    size_t prominences_length = scratch.min_prominence.size();
 
     out.reserve(prominences_length);
     for (size_t i = 0; i < prominences_length; ++i) {
-        peak p = {peaks_min_prominence.at(i).location, spectrum.at(peaks_min_prominence.at(i).location)};
+        peak p = {scratch.min_prominence.at(i).location, spectrum.at(scratch.min_prominence.at(i).location)};
         out.push_back(p);
     }
-    return out;
 }
 
 }  // namespace VC_PWQ::PeakFiltering
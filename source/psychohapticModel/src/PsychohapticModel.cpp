@@ -13,22 +13,106 @@
 
 #include "../include/PsychohapticModel.hpp"
 
+#include <mutex>
+
 namespace VC_PWQ {
 
+// the FFTW planner (plan creation and destruction, wisdom) is not thread-safe, only the execution of plans is; all
+// planner calls are serialized, so models can be initialized from several threads
+static std::mutex planner_mutex;
+
 /**
  * @brief constructor
  */
 PsychohapticModel::PsychohapticModel() {}
 
+/**
+ * @brief destructor; releases the DCT plan and buffers
+ */
+PsychohapticModel::~PsychohapticModel() {
+    destroyPlan();
+}
+
+/**
+ * @brief move constructor; takes over the DCT plan and buffers
+ */
+PsychohapticModel::PsychohapticModel(PsychohapticModel&& other) noexcept
+    : book(std::move(other.book)),
+      book_cumulative(std::move(other.book_cumulative)),
+      l_book(other.l_book),
+      bl(other.bl),
+      fs(other.fs),
+      freqs(std::move(other.freqs)),
+      percthres(std::move(other.percthres)),
+      dct_plan(other.dct_plan),
+      dct_in(other.dct_in),
+      dct_out(other.dct_out),
+      planner_flags(other.planner_flags),
+      batch_plan(other.batch_plan),
+      batch_in(other.batch_in),
+      batch_out(other.batch_out),
+      batch_channels(other.batch_channels) {
+    other.dct_plan = nullptr;
+    other.dct_in = nullptr;
+    other.dct_out = nullptr;
+    other.batch_plan = nullptr;
+    other.batch_in = nullptr;
+    other.batch_out = nullptr;
+    other.batch_channels = 0;
+}
+
+/**
+ * @brief move assignment; takes over the DCT plan and buffers
+ */
+auto PsychohapticModel::operator=(PsychohapticModel&& other) noexcept -> PsychohapticModel& {
+    if (this != &other) {
+        destroyPlan();
+        book = std::move(other.book);
+        book_cumulative = std::move(other.book_cumulative);
+        l_book = other.l_book;
+        bl = other.bl;
+        fs = other.fs;
+        freqs = std::move(other.freqs);
+        percthres = std::move(other.percthres);
+        dct_plan = other.dct_plan;
+        dct_in = other.dct_in;
+        dct_out = other.dct_out;
+        planner_flags = other.planner_flags;
+        batch_plan = other.batch_plan;
+        batch_in = other.batch_in;
+        batch_out = other.batch_out;
+        batch_channels = other.batch_channels;
+        other.dct_plan = nullptr;
+        other.dct_in = nullptr;
+        other.dct_out = nullptr;
+        other.batch_plan = nullptr;
+        other.batch_in = nullptr;
+        other.batch_out = nullptr;
+        other.batch_channels = 0;
+    }
+    return *this;
+}
+
 /**
  * @brief initialize model
+ * @details the DCT plan for the block length is created here and reused for every block
  * @param bl block length
  * @param fs sampling frequency
+ * @param mode FFTW planning effort; MEASURE and PATIENT pay off for long signals or with imported wisdom
  */
-void PsychohapticModel::init(int bl, int fs) {
+void PsychohapticModel::init(int bl, int fs, PlanningMode mode) {
     this->bl = bl;
     this->fs = fs;
 
+    destroyPlan();
+    planner_flags = plannerFlags(mode);
+    dct_in = fftw_alloc_real(bl);
+    dct_out = fftw_alloc_real(bl);
+    {
+        std::lock_guard<std::mutex> lock(planner_mutex);
+        dct_plan = fftw_plan_r2r_1d(bl, dct_in, dct_out, FFTW_REDFT10, planner_flags);
+    }
+
     int dwtlevel = (int)log2((double)bl) - 2;
 
     l_book = dwtlevel + 1;
@@ -85,26 +169,26 @@ auto PsychohapticModel::getSMR(std::vector<double>& block) -> pmResult {
     fftw_destroy_plan(p);
     fftw_free(in);
     fftw_free(out);*/
-    std::vector<double> spect = DCT(block);
-
-    std::vector<double> globalmask(bl, 0);
-    globalMaskingThreshold(spect, globalmask);
-
     pmResult result(l_book);
-
-    std::vector<double> maskenergy(l_book, 0);
-    int i = 0;
-    for (int b = 0; b < l_book; b++) {
-        result.bandenergy[b] = 0;
-        for (; i < book_cumulative[b + 1]; i++) {
-            result.bandenergy[b] += pow(BASE_LOG, spect[i] / FACTOR_LOG);
-            maskenergy[b] += globalmask[i];
-        }
-        result.SMR[b] = FACTOR_LOG * log10(result.bandenergy[b] / maskenergy[b]);
-    }
+    getSMR(block, result.SMR, result.bandenergy);
     return result;
 }
 
+/**
+ * @brief apply psychohaptic model on signal block without allocating
+ * @details return arrays have to be as large as the book for the DWT; the intermediate spectrum, mask and peak lists
+ * are kept in the model and reused for the next block
+ * @param block input signal
+ * @param SMR    return array for SMR
+ * @param bandenergy    return array for bandenergy
+ */
+void PsychohapticModel::getSMR(const std::vector<double>& block,
+                               std::vector<double>& SMR,
+                               std::vector<double>& bandenergy) {
+    blockDCT(block, spect);
+    bandAnalysis(spect, SMR.data(), bandenergy.data());
+}
+
 /**
  * @brief apply psychohaptic model on signal block, MD
  * @details return arrays have to be as large as the book for the DWT
@@ -115,13 +199,59 @@ auto PsychohapticModel::getSMR(std::vector<double>& block) -> pmResult {
 void PsychohapticModel::getSMR_MD(std::vector<std::vector<double>>* block,
                                   std::vector<std::vector<double>>& SMR,
                                   std::vector<std::vector<double>>& bandenergy) {
-    size_t channels = block->size();
+    int channels = (int)block->size();
+
+    std::vector<double> blocks((size_t)channels * bl);
+    for (int c = 0; c < channels; c++) {
+        std::copy(block->at(c).begin(), block->at(c).begin() + bl, blocks.begin() + (long)c * bl);
+        SMR[c].resize(l_book);
+        bandenergy[c].resize(l_book);
+    }
+    getSMR_Batch(blocks, channels, SMR, bandenergy);
+}
+
+/**
+ * @brief apply psychohaptic model on the blocks of all channels with one batched DCT
+ * @details the plan for the batch is cached for the last used channel number; return arrays have to hold one vector
+ * per channel, each as large as the book for the DWT
+ * @param blocks input signal blocks, channel-major (block of channel c starts at c * bl)
+ * @param channels number of channels
+ * @param SMR    return array for SMR
+ * @param bandenergy    return array for bandenergy
+ */
+void PsychohapticModel::getSMR_Batch(const std::vector<double>& blocks,
+                                     int channels,
+                                     std::vector<std::vector<double>>& SMR,
+                                     std::vector<std::vector<double>>& bandenergy) {
+    planBatch(channels);
+    std::copy(blocks.begin(), blocks.begin() + (long)channels * bl, batch_in);
+    fftw_execute(batch_plan);
+
+    for (int c = 0; c < channels; c++) {
+        logSpectrum(batch_out + (size_t)c * bl, bl, spect);
+        bandAnalysis(spect, SMR[c].data(), bandenergy[c].data());
+    }
+}
+
+/**
+ * @brief compute SMR and energy for each band from the spectrum of a block
+ * @param spect spectrum of the block in dB
+ * @param SMR    return array for SMR, as large as the book
+ * @param bandenergy    return array for bandenergy, as large as the book
+ */
+void PsychohapticModel::bandAnalysis(std::vector<double>& spect, double* SMR, double* bandenergy) {
+    globalmask.resize(bl);
+    globalMaskingThreshold(spect, globalmask);
 
-    for (size_t c = 0; c < channels; c++) {
-        std::vector<double> temp = block->at(c);
-        pmResult pmres = getSMR(temp);
-        SMR[c] = pmres.SMR;
-        bandenergy[c] = pmres.bandenergy;
+    maskenergy.assign(l_book, 0);
+    int i = 0;
+    for (int b = 0; b < l_book; b++) {
+        bandenergy[b] = 0;
+        for (; i < book_cumulative[b + 1]; i++) {
+            bandenergy[b] += pow(BASE_LOG, spect[i] / FACTOR_LOG);
+            maskenergy[b] += globalmask[i];
+        }
+        SMR[b] = FACTOR_LOG * log10(bandenergy[b] / maskenergy[b]);
     }
 }
 
@@ -133,8 +263,8 @@ void PsychohapticModel::getSMR_MD(std::vector<std::vector<double>>* block,
 void PsychohapticModel::globalMaskingThreshold(std::vector<double>& spect, std::vector<double>& globalmask) {
 
     double min_peak_height = findMaxVector(spect) - MIN_HEIGHT_DIFF;
-    std::vector<peak> peaks = FindPeaks(spect, MIN_PEAK_PROMINENCE, min_peak_height);
-    std::vector<double> mask = PeakMask(peaks);
+    FindPeaks(spect, MIN_PEAK_PROMINENCE, min_peak_height, peak_scratch, peaks);
+    PeakMask(peaks, mask);
     if (mask.empty()) {
         for (int i = 0; i < bl; i++) {
             globalmask[i] = percthres[i];  // percthres is in linear domain
@@ -172,13 +302,11 @@ void PsychohapticModel::perceptualThreshold() {
 
 /**
  * @brief Compute mask based on detected peaks
- * @param peaks_height   height of detected peaks
- * @param peaks_loc   location of detected peaks
- * @param mask   output vector for mask
+ * @param peaks   detected peaks
+ * @param mask   output vector for mask; empty if there are no peaks
  */
-auto PsychohapticModel::PeakMask(std::vector<peak>& peaks) -> std::vector<double> {
+void PsychohapticModel::PeakMask(std::vector<peak>& peaks, std::vector<double>& mask) {
 
-    std::vector<double> mask;
     if (peaks.empty()) {
         mask.clear();
     } else {
@@ -215,7 +343,6 @@ auto PsychohapticModel::PeakMask(std::vector<peak>& peaks) -> std::vector<double
             }
         }
     }
-    return mask;
 }
 
 /**
@@ -233,31 +360,150 @@ void PsychohapticModel::setFreqVector(int fs, size_t bl) {
     }
 }
 
+/**
+ * @brief compute the DCT spectrum of a vector in dB
+ * @details a plan is created for every call; use the model's cached plan for repeated transforms
+ * @param data input vector
+ * @return spectrum in dB
+ */
 auto PsychohapticModel::DCT(std::vector<double>& data) -> std::vector<double> {
 
     int size = (int)data.size();
     std::vector<double> spect;
-    spect.reserve(size);
 
-    double in[size];
-    double out[size];
+    double* in = fftw_alloc_real(size);
+    double* out = fftw_alloc_real(size);
+    fftw_plan p = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(planner_mutex);
+        p = fftw_plan_r2r_1d(size, in, out, FFTW_REDFT10, FFTW_ESTIMATE);
+    }
 
     std::copy(data.begin(), data.end(), in);
-
-    fftw_plan p = fftw_plan_r2r_1d(size, in, out, FFTW_REDFT10, FFTW_ESTIMATE);
     fftw_execute(p);
+    logSpectrum(out, size, spect);
+
+    {
+        std::lock_guard<std::mutex> lock(planner_mutex);
+        fftw_destroy_plan(p);
+    }
+    fftw_free(in);
+    fftw_free(out);
+
+    return spect;
+}
+
+/**
+ * @brief compute the DCT spectrum of a signal block in dB using the cached plan
+ * @param block input signal block of length bl
+ * @param spect output spectrum in dB
+ */
+void PsychohapticModel::blockDCT(const std::vector<double>& block, std::vector<double>& spect) {
+    std::copy(block.begin(), block.begin() + bl, dct_in);
+    fftw_execute(dct_plan);
+    logSpectrum(dct_out, bl, spect);
+}
 
-    spect.push_back(20 * log10(std::abs(out[0] / (2 * sqrt(size)))));
+/**
+ * @brief convert DCT coefficients (FFTW_REDFT10) to an orthonormal spectrum in dB
+ * @param dct DCT coefficients
+ * @param size number of coefficients
+ * @param spect output spectrum
+ */
+void PsychohapticModel::logSpectrum(const double* dct, int size, std::vector<double>& spect) {
+    spect.clear();
+    spect.reserve(size);
+    spect.push_back(20 * log10(std::abs(dct[0] / (2 * sqrt(size)))));
     double temp = 1 / (sqrt(2 * size));
     for (int i = 1; i < size; i++) {
-        // spect.push_back(20 * log10(temp * sqrt(out[0])));
-        spect.push_back(20 * log10(std::abs(temp * out[i])));
-        // spect.push_back(temp * out[i]);
+        spect.push_back(20 * log10(std::abs(temp * dct[i])));
+    }
+}
+
+/**
+ * @brief import FFTW wisdom, so tuned plans are created without measuring again
+ * @details has to be called before the models are initialized
+ * @param filename wisdom file
+ * @return true if the wisdom was imported
+ */
+auto PsychohapticModel::importWisdom(const std::string& filename) -> bool {
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    return fftw_import_wisdom_from_filename(filename.c_str()) != 0;
+}
+
+/**
+ * @brief export the accumulated FFTW wisdom
+ * @param filename wisdom file
+ * @return true if the wisdom was exported
+ */
+auto PsychohapticModel::exportWisdom(const std::string& filename) -> bool {
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    return fftw_export_wisdom_to_filename(filename.c_str()) != 0;
+}
+
+/**
+ * @brief map planning mode to FFTW planner flags
+ * @param mode planning mode
+ * @return planner flags
+ */
+auto PsychohapticModel::plannerFlags(PlanningMode mode) -> unsigned {
+    switch (mode) {
+        case PlanningMode::MEASURE:
+            return FFTW_MEASURE;
+        case PlanningMode::PATIENT:
+            return FFTW_PATIENT;
+        default:
+            return FFTW_ESTIMATE;
     }
+}
 
-    fftw_destroy_plan(p);
+/**
+ * @brief create plan and buffers for a batched DCT over all channels, if not already available
+ * @param channels number of channels
+ */
+void PsychohapticModel::planBatch(int channels) {
+    if (batch_plan != nullptr && batch_channels == channels) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    if (batch_plan != nullptr) {
+        fftw_destroy_plan(batch_plan);
+    }
+    fftw_free(batch_in);
+    fftw_free(batch_out);
+
+    int n = bl;
+    fftw_r2r_kind kind = FFTW_REDFT10;
+    batch_in = fftw_alloc_real((size_t)channels * bl);
+    batch_out = fftw_alloc_real((size_t)channels * bl);
+    batch_plan = fftw_plan_many_r2r(
+        1, &n, channels, batch_in, nullptr, 1, bl, batch_out, nullptr, 1, bl, &kind, planner_flags);
+    batch_channels = channels;
+}
 
-    return spect;
+/**
+ * @brief release DCT plans and buffers
+ */
+void PsychohapticModel::destroyPlan() {
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    if (dct_plan != nullptr) {
+        fftw_destroy_plan(dct_plan);
+        dct_plan = nullptr;
+    }
+    fftw_free(dct_in);
+    fftw_free(dct_out);
+    dct_in = nullptr;
+    dct_out = nullptr;
+
+    if (batch_plan != nullptr) {
+        fftw_destroy_plan(batch_plan);
+        batch_plan = nullptr;
+    }
+    fftw_free(batch_in);
+    fftw_free(batch_out);
+    batch_in = nullptr;
+    batch_out = nullptr;
+    batch_channels = 0;
 }
 
 }  // namespace VC_PWQ
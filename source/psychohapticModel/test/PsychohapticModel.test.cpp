@@ -11,7 +11,9 @@
 
 #include "../include/PsychohapticModel.hpp"
 
+#include <cmath>
 #include <iostream>
+#include <utility>
 #include <vector>
 
 #include <catch2/catch_all.hpp>
@@ -32,3 +34,60 @@ TEST_CASE("DCT") {
         std::cout << std::endl;*/
     }
 }
+
+TEST_CASE("PsychohapticModel") {
+
+    static constexpr int bl = 64;
+    static constexpr int fs = 8000;
+
+    std::vector<double> block(bl, 0);
+    for (int i = 0; i < bl; i++) {
+        block[i] = sin(0.3 * i) + 0.2 * cos(1.7 * i);  // NOLINT
+    }
+
+    SECTION("moved model keeps its cached plan") {
+        VC_PWQ::PsychohapticModel reference;
+        reference.init(bl, fs);
+        VC_PWQ::pmResult expected = reference.getSMR(block);
+
+        VC_PWQ::PsychohapticModel source;
+        source.init(bl, fs);
+        VC_PWQ::PsychohapticModel model(std::move(source));
+        VC_PWQ::pmResult result = model.getSMR(block);
+
+        REQUIRE(result.SMR.size() == expected.SMR.size());
+        for (size_t i = 0; i < expected.SMR.size(); i++) {
+            CHECK(result.SMR[i] == expected.SMR[i]);
+            CHECK(result.bandenergy[i] == expected.bandenergy[i]);
+        }
+    }
+
+    SECTION("batched channels match single blocks exactly") {
+        // any difference in the last bit changes the bit allocation of multichannel streams
+        for (int length : {32, 64, 128, 256, 512}) {  // NOLINT
+            for (int channels : {1, 2, 3, 8}) {  // NOLINT
+                const int bands = (int)log2(length) - 1;
+                VC_PWQ::PsychohapticModel model;
+                model.init(length, fs);
+
+                std::vector<double> blocks((size_t)channels * length);
+                for (int c = 0; c < channels; c++) {
+                    for (int i = 0; i < length; i++) {
+                        blocks[(size_t)c * length + i] = sin((0.3 + 0.11 * c) * i) + 0.2 * cos(1.7 * i);  // NOLINT
+                    }
+                }
+                std::vector<std::vector<double>> SMR(channels, std::vector<double>(bands));
+                std::vector<std::vector<double>> bandenergy(channels, std::vector<double>(bands));
+                model.getSMR_Batch(blocks, channels, SMR, bandenergy);
+
+                for (int c = 0; c < channels; c++) {
+                    std::vector<double> single(blocks.begin() + (long)c * length,
+                                               blocks.begin() + (long)(c + 1) * length);
+                    VC_PWQ::pmResult expected = model.getSMR(single);
+                    CHECK(SMR[c] == expected.SMR);
+                    CHECK(bandenergy[c] == expected.bandenergy);
+                }
+            }
+        }
+    }
+}
@@ -22,6 +22,9 @@
 
 using VC_PWQ::DecoderInterface;
 using VC_PWQ::EncoderInterface;
+using VC_PWQ::EntropyCoder;
+using VC_PWQ::PlanningMode;
+using VC_PWQ::PsychohapticModel;
 
 auto main(int argc, const char* argv[]) -> int {
 
@@ -44,6 +47,17 @@ auto main(int argc, const char* argv[]) -> int {
 
     bool enable_md = false;
 
+    PlanningMode planning = PlanningMode::ESTIMATE;
+    std::string wisdomfile;
+    EntropyCoder coder = EntropyCoder::ARITHMETIC;
+    int threads = 1;
+    int slices = 0;
+    std::string stats_prefix;
+    double kbps = 0;
+    int rate_buffer = 0;
+    bool scalable = false;
+    bool seekable = false;
+
     for (size_t i = 0; i < arguments.size(); i++) {
         const auto l = arguments[i];
         if (l == "-i") {
@@ -69,6 +83,39 @@ auto main(int argc, const char* argv[]) -> int {
         } else if (l == "-ch") {
             i++;
             maxchannels = std::stoi(arguments[i]);
+        } else if (l == "-plan") {
+            i++;
+            if (arguments[i] == "measure") {
+                planning = PlanningMode::MEASURE;
+            } else if (arguments[i] == "patient") {
+                planning = PlanningMode::PATIENT;
+            } else {
+                planning = PlanningMode::ESTIMATE;
+            }
+        } else if (l == "-wisdom") {
+            i++;
+            wisdomfile = arguments[i];
+        } else if (l == "-j") {
+            i++;
+            threads = std::stoi(arguments[i]);
+        } else if (l == "-slices") {
+            i++;
+            slices = std::stoi(arguments[i]);
+        } else if (l == "-rc") {
+            coder = EntropyCoder::RANGE;
+        } else if (l == "-kbps") {
+            i++;
+            kbps = std::stod(arguments[i]);
+        } else if (l == "-buffer") {
+            i++;
+            rate_buffer = std::stoi(arguments[i]);
+        } else if (l == "-scalable") {
+            scalable = true;
+        } else if (l == "-seekable") {
+            seekable = true;
+        } else if (l == "-stats") {
+            i++;
+            stats_prefix = arguments[i];
         } else if (l == "-h" || l == "--help") {
             std::cout << "This is the demo program of the VC-PWQ. It can be used to compress vibrotactile signals "
                          "provided as .wav, .txt and .csv files (channels as rows) in a folder."
@@ -86,6 +133,32 @@ auto main(int argc, const char* argv[]) -> int {
                 << std::endl;
             std::cout << "-fs <integer number>: \tspecify sampling frequency. Default: 2800" << std::endl;
             std::cout << "-ch <folder>: \t\tspecify maximum channel number. Default: 8" << std::endl;
+            std::cout << "-plan <estimate|measure|patient>: specify FFTW planning effort. Default: estimate" << std::endl;
+            std::cout << "-wisdom <file>: \tload FFTW wisdom from file and store updated wisdom after encoding"
+                      << std::endl;
+            std::cout << "-j <integer number>: \tspecify number of threads for encoding and decoding, 0 for all cores. "
+                         "Default: 1"
+                      << std::endl;
+            std::cout << "-slices <integer number>: reset the entropy coder every n blocks, so the slices can be "
+                         "decoded independently. Default: 0 (disabled)"
+                      << std::endl;
+            std::cout << "-rc: \t\t\tuse the range coder instead of the arithmetic coder. Default: disabled"
+                      << std::endl;
+            std::cout << "-kbps <number>: \tadapt the bit budget of every block to a target rate in kbit/s; the bit "
+                         "budget is the upper limit. Default: 0 (disabled)"
+                      << std::endl;
+            std::cout << "-buffer <integer number>: buffer size in bits for the target rate. Default: 1 second of "
+                         "the target rate"
+                      << std::endl;
+            std::cout << "-scalable: \t\tcode scalable streams, whose blocks can be truncated at any byte. Default: "
+                         "disabled"
+                      << std::endl;
+            std::cout << "-seekable: \t\tcode seekable streams with container info and block index. Default: "
+                         "disabled"
+                      << std::endl;
+            std::cout << "-stats <prefix>: \twrite per-stage timing and counters to <prefix>_encoder.json and "
+                         "<prefix>_decoder.json; requires a build with ENABLE_STATS"
+                      << std::endl;
             std::cout << "-h/--help: \t\tdisplay this help text" << std::endl;
             return 0;
         }
@@ -99,8 +172,21 @@ auto main(int argc, const char* argv[]) -> int {
 
     bool txt_mode = false;
 
-    EncoderInterface encInterface(fs);            // fs can be left out for .wav files - encoder takes fs from .wav file
+    if (!wisdomfile.empty()) {
+        PsychohapticModel::importWisdom(wisdomfile);
+    }
+
+    EncoderInterface encInterface(fs, planning);  // fs can be left out for .wav files - encoder takes fs from .wav file
+    encInterface.setEntropyCoder(coder);
+    encInterface.setThreads(threads);
+    encInterface.setSlices(slices);
+    encInterface.setScalable(scalable);
+    encInterface.setSeekable(seekable);
+    if (kbps > 0) {
+        encInterface.setRateControl(kbps, rate_buffer > 0 ? rate_buffer : (int)(kbps * 1000));  // NOLINT
+    }
     DecoderInterface decInterface(txt_mode, fs);  // fs optional, for .wav files with custom sampling frequencies
+    decInterface.setThreads(threads);
 
     std::cout << "starting encoding" << std::endl;
     for (const auto& b : bitbudgets) {
@@ -115,6 +201,10 @@ auto main(int argc, const char* argv[]) -> int {
 
     std::cout << "encoding done" << std::endl;
 
+    if (!wisdomfile.empty()) {
+        PsychohapticModel::exportWisdom(wisdomfile);
+    }
+
     std::cout << "starting decoding" << std::endl;
     // Encode .binary files in folder "Data_compressed" and put it into folder "Data_decoded"
     if (enable_md) {
@@ -125,5 +215,12 @@ auto main(int argc, const char* argv[]) -> int {
 
     std::cout << "decoding done" << std::endl;
 
+    if (!stats_prefix.empty()) {
+        if (!encInterface.saveStats(stats_prefix + "_encoder.json") ||
+            !decInterface.saveStats(stats_prefix + "_decoder.json")) {
+            std::cout << "could not write statistics: " << stats_prefix << std::endl;
+        }
+    }
+
     return 0;
 }
@@ -0,0 +1,82 @@
+//=======================================================================
+/** @file Bitstream.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Packed bitstream writer and reader. Bits are stored LSB first in consecutive bytes, which is also the layout of the
+ * .binary files.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef Bitstream_hpp
+#define Bitstream_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VC_PWQ {
+
+static constexpr int MAX_FIELD_BITS = 56;
+static constexpr int BYTE_SIZE = 8;
+
+class BitWriter {
+  public:
+    BitWriter() = default;
+
+    void write(uint64_t value, int length);
+    void writeBit(int bit);
+    void append(const BitWriter& other);
+    void append(const BitWriter& other, size_t length);
+
+    void resize(size_t length);
+    void reserve(size_t length);
+    void clear();
+    void discardBytes(size_t bytes);
+
+    [[nodiscard]] auto at(size_t pos) const -> int;
+    [[nodiscard]] auto size() const -> size_t;
+    [[nodiscard]] auto empty() const -> bool;
+    [[nodiscard]] auto data() const -> const uint8_t*;
+    [[nodiscard]] auto sizeBytes() const -> size_t;
+
+  private:
+    std::vector<uint8_t> buffer;
+    size_t length = 0;
+};
+
+class BitReader {
+  public:
+    BitReader() = default;
+    BitReader(const uint8_t* data, size_t length);
+    explicit BitReader(const BitWriter& writer);
+
+    auto read(int length) -> uint64_t;
+    auto readBit() -> int;
+    [[nodiscard]] auto peek(int length) const -> uint64_t;
+    void skip(size_t length);
+    void seek(size_t pos);
+
+    [[nodiscard]] auto sub(size_t pos, size_t length) const -> BitReader;
+    [[nodiscard]] auto position() const -> size_t;
+    [[nodiscard]] auto size() const -> size_t;
+    [[nodiscard]] auto remaining() const -> size_t;
+
+  private:
+    BitReader(const uint8_t* data, size_t begin, size_t end);
+
+    [[nodiscard]] auto loadWord(size_t pos) const -> uint64_t;
+
+    const uint8_t* data = nullptr;
+    size_t begin = 0;
+    size_t end = 0;
+    size_t pos = 0;
+};
+
+}  // namespace VC_PWQ
+
+#endif /* Bitstream_hpp */
@@ -0,0 +1,58 @@
+//=======================================================================
+/** @file MappedFile.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Read-only memory mapping of a file. The decoders read the bits directly from the mapping, without copying the
+ * file; the pages are shared with other processes mapping the same file. Platforms without mmap read the file into
+ * memory instead.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef MappedFile_hpp
+#define MappedFile_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Bitstream.hpp"
+
+namespace VC_PWQ {
+
+class MappedFile {
+  public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& name);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+    auto open(const std::string& name) -> bool;
+    void close();
+
+    [[nodiscard]] auto isOpen() const -> bool;
+    [[nodiscard]] auto data() const -> const uint8_t*;
+    [[nodiscard]] auto size() const -> size_t;
+    [[nodiscard]] auto reader() const -> BitReader;
+
+  private:
+    const uint8_t* mapping = nullptr;
+    size_t length = 0;
+    bool opened = false;
+
+    // file content, if the file could not be mapped
+    std::vector<uint8_t> fallback;
+};
+
+}  // namespace VC_PWQ
+
+#endif /* MappedFile_hpp */
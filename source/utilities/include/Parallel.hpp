@@ -0,0 +1,28 @@
+//=======================================================================
+/** @file Parallel.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Scheduling of independent tasks (e.g. files of a folder) on a number of worker threads. Idle workers take the next
+ * open task, so long and short tasks are balanced dynamically.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef Parallel_hpp
+#define Parallel_hpp
+
+#include <cstddef>
+#include <functional>
+
+namespace VC_PWQ {
+
+auto resolveThreads(int threads, size_t tasks) -> int;
+void parallelFor(size_t tasks, int threads, const std::function<void(size_t task, int worker)>& body);
+
+}  // namespace VC_PWQ
+
+#endif /* Parallel_hpp */
@@ -0,0 +1,45 @@
+//=======================================================================
+/** @file Simd.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Vectorized kernels for the wavelet transform, quantization and block scans. The implementation is selected once at
+ * runtime (AVX2 on x86 if the CPU supports it, NEON on AArch64, scalar otherwise). All implementations evaluate the
+ * same operations in the same order, so the results are bit-identical.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef Simd_hpp
+#define Simd_hpp
+
+namespace VC_PWQ::Simd {
+
+enum class Level { SCALAR, AVX2, NEON };
+
+auto bestLevel() -> Level;
+auto activeLevel() -> Level;
+auto setLevel(Level level) -> bool;
+
+// lifting steps of the CDF 9/7 wavelet transform
+void lift(const double* in, double* out, int n, double h);
+void liftShift(const double* in, double* out, int n, double h);
+void splitPredict(const double* data, double* even, double* odd, int n_half, double h);
+void updateScale(const double* even, const double* odd, double* data, int n_half, double h, double scale);
+void unscaleUpdate(const double* data, double* even, double* odd, int n_half, double h, double scale);
+void predictMerge(const double* even, const double* odd, double* data, int n_half, double h);
+
+// quantization
+void quantize(const double* in, double* out, int length, double delta, double max_q);
+void dequantize(const int* in, double* out, int length, double factor);
+
+// block scans
+auto absMax(const double* data, int length) -> double;
+auto anyAbove(const double* data, int length, double threshold) -> bool;
+
+}  // namespace VC_PWQ::Simd
+
+#endif /* Simd_hpp */
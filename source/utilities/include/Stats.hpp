@@ -0,0 +1,132 @@
+//=======================================================================
+/** @file Stats.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Per-stage timing and counters of the encoder and decoder. The instrumentation is only compiled in if VC_PWQ_STATS
+ * is defined (CMake option ENABLE_STATS); otherwise the timers and counters are empty inline functions and the
+ * statistics stay zero.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef Stats_hpp
+#define Stats_hpp
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "../../constants/constants.hpp"
+
+namespace VC_PWQ {
+
+#ifdef VC_PWQ_STATS
+static constexpr bool STATS_ENABLED = true;
+#else
+static constexpr bool STATS_ENABLED = false;
+#endif
+
+enum class Stage { DWT, PSYCHOHAPTIC_MODEL, BIT_ALLOCATION, QUANTIZATION, SPIHT, ENTROPY_CODING, IO };
+static constexpr size_t STAGES = 7;
+
+struct Stats {
+    // wall time per stage in seconds
+    std::array<double, STAGES> seconds{};
+
+    uint64_t blocks = 0;
+    // coded bits of all blocks, including the length fields
+    uint64_t bits = 0;
+    uint64_t allocation_iterations = 0;
+    std::array<uint64_t, CONTEXTS> symbols{};
+    uint64_t renormalizations = 0;
+
+    void reset();
+    void merge(const Stats& other);
+    [[nodiscard]] auto toJSON() const -> std::string;
+
+    inline void addBlock(size_t block_bits);
+    inline void addAllocationIterations(int iterations);
+};
+
+auto stageName(Stage stage) -> const char*;
+auto saveStats(const Stats& stats, const std::string& filename) -> bool;
+
+/**
+ * @brief scoped timer; adds the wall time of its lifetime to a stage
+ */
+class StageTimer {
+  public:
+#ifdef VC_PWQ_STATS
+    StageTimer(Stats& stats, Stage stage) : stats(stats), stage(stage), start(std::chrono::steady_clock::now()) {}
+    ~StageTimer() {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        stats.seconds[(size_t)stage] += elapsed.count();
+    }
+    StageTimer(const StageTimer&) = delete;
+    StageTimer(StageTimer&&) = delete;
+    auto operator=(const StageTimer&) -> StageTimer& = delete;
+    auto operator=(StageTimer&&) -> StageTimer& = delete;
+
+  private:
+    Stats& stats;
+    Stage stage;
+    std::chrono::steady_clock::time_point start;
+#else
+    StageTimer(Stats& /*stats*/, Stage /*stage*/) {}
+#endif
+};
+
+/**
+ * @brief count a coded block
+ * @param block_bits coded bits of the block
+ */
+inline void Stats::addBlock([[maybe_unused]] size_t block_bits) {
+#ifdef VC_PWQ_STATS
+    blocks++;
+    bits += block_bits;
+#endif
+}
+
+/**
+ * @brief count the iterations of a bit allocation
+ * @param iterations iterations of the greedy allocation loop
+ */
+inline void Stats::addAllocationIterations([[maybe_unused]] int iterations) {
+#ifdef VC_PWQ_STATS
+    allocation_iterations += iterations;
+#endif
+}
+
+/**
+ * @brief count an entropy coded symbol; the sink is optional
+ * @param stats statistics to update; may be nullptr
+ * @param context context of the symbol
+ */
+inline void countSymbol([[maybe_unused]] Stats* stats, [[maybe_unused]] int context) {
+#ifdef VC_PWQ_STATS
+    if (stats != nullptr) {
+        stats->symbols[context]++;
+    }
+#endif
+}
+
+/**
+ * @brief count a renormalization step of the entropy coder; the sink is optional
+ * @param stats statistics to update; may be nullptr
+ */
+inline void countRenormalization([[maybe_unused]] Stats* stats) {
+#ifdef VC_PWQ_STATS
+    if (stats != nullptr) {
+        stats->renormalizations++;
+    }
+#endif
+}
+
+}  // namespace VC_PWQ
+
+#endif /* Stats_hpp */
@@ -0,0 +1,99 @@
+//=======================================================================
+/** @file StreamHeader.hpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Optional stream header signalling coding tools beyond the original bitstream format. Streams without the header are
+ * decoded as before.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#ifndef StreamHeader_hpp
+#define StreamHeader_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../../constants/constants.hpp"
+#include "Bitstream.hpp"
+
+namespace VC_PWQ {
+
+static constexpr uint32_t STREAM_MAGIC = 0x51504356;  // "VCPQ"
+static constexpr int STREAM_MAGIC_BITS = 32;
+static constexpr int STREAM_VERSION = 2;
+static constexpr int STREAM_VERSION_BASE = 1;      // streams are written with the lowest version that describes them
+static constexpr int STREAM_VERSION_SEEKABLE = 2;  // container info
+static constexpr int STREAM_HEADER_BITS = STREAM_MAGIC_BITS + 2 * BYTE_SIZE;
+
+// flags of the stream header
+static constexpr uint32_t FLAG_RANGE_CODER = 1U << 0;
+static constexpr uint32_t FLAG_SLICES = 1U << 1;
+static constexpr uint32_t FLAG_SCALABLE = 1U << 2;
+static constexpr uint32_t FLAG_SEEKABLE = 1U << 3;
+
+// container info of seekable streams; replaces the channel count and the sampling frequency code
+static constexpr int CONTAINER_FS_BITS = 32;
+static constexpr int CONTAINER_BL_BITS = 16;
+static constexpr int CONTAINER_CHANNELS_BITS = 8;
+static constexpr int CONTAINER_SAMPLES_BITS = 48;
+static constexpr int CONTAINER_CHANNELS_MAX = (1 << CONTAINER_CHANNELS_BITS) - 1;
+
+// slice index: blocks per slice, number of slices and the byte offset of each slice relative to the first one
+static constexpr int SLICE_BLOCKS_BITS = 16;
+static constexpr int SLICE_COUNT_BITS = 32;
+static constexpr int SLICE_OFFSET_BITS = 32;
+static constexpr int SLICE_BLOCKS_MAX = (1 << SLICE_BLOCKS_BITS) - 1;
+
+struct StreamHeader {
+    int version = STREAM_VERSION;
+    uint32_t flags = 0;
+
+    [[nodiscard]] auto isLegacy() const -> bool {
+        return flags == 0;
+    }
+    [[nodiscard]] auto entropyCoder() const -> EntropyCoder {
+        return (flags & FLAG_RANGE_CODER) != 0 ? EntropyCoder::RANGE : EntropyCoder::ARITHMETIC;
+    }
+    [[nodiscard]] auto hasSlices() const -> bool {
+        return (flags & FLAG_SLICES) != 0;
+    }
+    [[nodiscard]] auto isScalable() const -> bool {
+        return (flags & FLAG_SCALABLE) != 0;
+    }
+    [[nodiscard]] auto isSeekable() const -> bool {
+        return (flags & FLAG_SEEKABLE) != 0;
+    }
+};
+
+struct ContainerInfo {
+    int fs = 0;
+    int bl = 0;
+    int channels = 0;
+    size_t samples = 0;  // per channel, without the padding of the last block
+};
+
+struct SliceIndex {
+    int slice_blocks = 0;
+    std::vector<size_t> offsets;  // in bytes, relative to the first slice
+};
+
+void writeStreamHeader(const StreamHeader& header, BitWriter& bitstream);
+auto readStreamHeader(BitReader& bitstream, StreamHeader& header) -> bool;
+
+void writeContainerInfo(const ContainerInfo& info, BitWriter& bitstream);
+auto readContainerInfo(BitReader& bitstream, ContainerInfo& info) -> bool;
+
+void writeSliceIndex(const SliceIndex& index, BitWriter& bitstream);
+auto readSliceIndex(BitReader& bitstream, SliceIndex& index) -> bool;
+void alignToByte(BitWriter& bitstream);
+void alignToByte(BitReader& bitstream);
+
+}  // namespace VC_PWQ
+
+#endif /* StreamHeader_hpp */
@@ -14,7 +14,6 @@
 #ifndef Utilities_hpp
 #define Utilities_hpp
 
-#include <bitset>
 #include <cmath>
 #include <complex>
 #include <filesystem>
@@ -23,12 +22,14 @@
 #include <sstream>
 #include <vector>
 
+#include "Bitstream.hpp"
+#include "types.hpp"
+
 // #include <fftw3.h>
 
 namespace VC_PWQ {
 
 static constexpr double HALF_QUANT = 0.5;
-static constexpr int BYTE_SIZE = 8;
 
 void uniformQuant(std::vector<double>& in, std::vector<double>& out, int start, int length, double max, int bits);
 auto uniformQuant(double& in, double max, int bits) -> double;
@@ -55,10 +56,7 @@ void abs_vector(std::vector<double>& data);
 auto variance(const std::vector<double>& in) -> double;
 auto energy(const std::vector<double>& in) -> double;
 
-void de2bi(int val, std::vector<char>* outstream, int length);
-void de2bi(int val, std::vector<char>* outstream, int length, size_t pos);
 // auto bi2de(int* pointer, int length) -> int;
-auto bi2de(std::vector<char>* pointer, int length, size_t pos) -> int;
 auto bi2de(std::vector<int>& data) -> int;
 
 template <typename T>
@@ -74,9 +72,11 @@ auto bitget(int in, int bit) -> int;
 // auto SNR(double* sig1, double* sig2, size_t size) -> double;
 
 auto checkZeros(std::vector<double>& sig, int length) -> bool;
+void copyBlock(const ChannelView& channel, size_t start, std::vector<double>& block);
 
-void loadBinary(const std::string& name, std::vector<char>& bitstream);
-void saveAsBinary(const std::string& name, std::vector<char>& bitstream);
+void loadBinary(const std::string& name, std::vector<uint8_t>& data);
+void saveAsBinary(const std::string& name, const BitWriter& bitstream);
+auto saveToBuffer(const BitWriter& bitstream, uint8_t* out, size_t capacity) -> bool;
 
 auto transposeMatrix(const std::vector<std::vector<double>>& in) -> std::vector<std::vector<double>>;
 
@@ -12,6 +12,8 @@
 #ifndef types_hpp
 #define types_hpp
 
+#include <cstddef>
+
 namespace VC_PWQ {
 
 struct pixel {
@@ -19,6 +21,13 @@ struct pixel {
     int type;
 };
 
+// non-owning view of one channel; sample i is data[i * stride]
+struct ChannelView {
+    const double* data;
+    size_t length;
+    size_t stride;
+};
+
 }  // namespace VC_PWQ
 
 #endif /* types_hpp */
@@ -0,0 +1,322 @@
+//=======================================================================
+/** @file Bitstream.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Packed bitstream writer and reader. Bits are stored LSB first in consecutive bytes, which is also the layout of the
+ * .binary files.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/Bitstream.hpp"
+
+#include <algorithm>
+
+namespace VC_PWQ {
+
+/**
+ * @brief return mask for the lowest bits of a 64 bit word
+ * @param length number of bits
+ * @return mask
+ */
+static auto lowMask(int length) -> uint64_t {
+    return (length >= 64) ? ~(uint64_t)0 : (((uint64_t)1 << length) - 1);
+}
+
+/**
+ * @brief write a field of bits, LSB first
+ * @details the field is shifted to the current bit offset in a 64 bit word and merged into the buffer bytewise
+ * @param value value to write
+ * @param length number of bits, at most MAX_FIELD_BITS
+ */
+void BitWriter::write(uint64_t value, int length) {
+    size_t pos = this->length >> 3;
+    int offset = (int)(this->length & (BYTE_SIZE - 1));
+    this->length += length;
+    buffer.resize((this->length + BYTE_SIZE - 1) >> 3, 0);
+
+    uint64_t word = (value & lowMask(length)) << offset;
+    while (word != 0) {
+        buffer[pos] |= (uint8_t)word;
+        word >>= BYTE_SIZE;
+        pos++;
+    }
+}
+
+/**
+ * @brief write a single bit
+ * @param bit bit to write (0 or 1)
+ */
+void BitWriter::writeBit(int bit) {
+    int offset = (int)(length & (BYTE_SIZE - 1));
+    if (offset == 0) {
+        buffer.push_back(0);
+    }
+    buffer.back() |= (uint8_t)((bit & 1) << offset);
+    length++;
+}
+
+/**
+ * @brief append a complete bitstream
+ * @param other bitstream to append
+ */
+void BitWriter::append(const BitWriter& other) {
+    append(other, other.size());
+}
+
+/**
+ * @brief append the first bits of a bitstream
+ * @details complete source bytes are copied in bulk; at an unaligned position each byte is split over two bytes
+ * @param other bitstream to append
+ * @param length number of bits to append
+ */
+void BitWriter::append(const BitWriter& other, size_t length) {
+    if (length > other.size()) {
+        length = other.size();
+    }
+    int offset = (int)(this->length & (BYTE_SIZE - 1));
+    size_t pos = this->length >> 3;
+    size_t bytes = length >> 3;
+    this->length += length;
+    buffer.resize((this->length + BYTE_SIZE - 1) >> 3, 0);
+
+    const uint8_t* in = other.data();
+    if (offset == 0) {
+        std::copy(in, in + bytes, buffer.begin() + (long)pos);
+    } else {
+        for (size_t i = 0; i < bytes; i++) {
+            buffer[pos + i] |= (uint8_t)(in[i] << offset);
+            buffer[pos + i + 1] = (uint8_t)(in[i] >> (BYTE_SIZE - offset));
+        }
+    }
+
+    int rest = (int)(length & (BYTE_SIZE - 1));
+    if (rest > 0) {
+        uint64_t word = (uint64_t)(in[bytes] & lowMask(rest)) << offset;
+        buffer[pos + bytes] |= (uint8_t)word;
+        if ((word >> BYTE_SIZE) != 0) {
+            buffer[pos + bytes + 1] |= (uint8_t)(word >> BYTE_SIZE);
+        }
+    }
+}
+
+/**
+ * @brief truncate the bitstream or extend it with zeros
+ * @param length new number of bits
+ */
+void BitWriter::resize(size_t length) {
+    buffer.resize((length + BYTE_SIZE - 1) >> 3, 0);
+    int offset = (int)(length & (BYTE_SIZE - 1));
+    if (offset != 0) {
+        buffer.back() &= (uint8_t)lowMask(offset);
+    }
+    this->length = length;
+}
+
+/**
+ * @brief reserve memory
+ * @param length expected number of bits
+ */
+void BitWriter::reserve(size_t length) {
+    buffer.reserve((length + BYTE_SIZE - 1) >> 3);
+}
+
+/**
+ * @brief remove all bits; allocated memory is kept
+ */
+void BitWriter::clear() {
+    buffer.clear();
+    length = 0;
+}
+
+/**
+ * @brief remove complete bytes from the front, e.g. after they have been sent; allocated memory is kept
+ * @param bytes number of bytes to remove; at most the number of complete bytes
+ */
+void BitWriter::discardBytes(size_t bytes) {
+    bytes = std::min(bytes, length >> 3);
+    buffer.erase(buffer.begin(), buffer.begin() + (long)bytes);
+    length -= bytes * BYTE_SIZE;
+}
+
+/**
+ * @brief return bit at specified position
+ * @param pos bit index
+ * @return bit value
+ */
+auto BitWriter::at(size_t pos) const -> int {
+    return (buffer.at(pos >> 3) >> (pos & (BYTE_SIZE - 1))) & 1;
+}
+
+/**
+ * @brief return number of bits
+ * @return number of bits
+ */
+auto BitWriter::size() const -> size_t {
+    return length;
+}
+
+/**
+ * @brief check if no bit has been written
+ * @return true if empty
+ */
+auto BitWriter::empty() const -> bool {
+    return length == 0;
+}
+
+/**
+ * @brief return pointer to the packed bytes; unused bits of the last byte are zero
+ * @return pointer to the first byte
+ */
+auto BitWriter::data() const -> const uint8_t* {
+    return buffer.data();
+}
+
+/**
+ * @brief return number of packed bytes
+ * @return number of bytes
+ */
+auto BitWriter::sizeBytes() const -> size_t {
+    return buffer.size();
+}
+
+/**
+ * @brief constructor
+ * @param data packed bytes; have to stay valid while the reader is used
+ * @param length number of valid bits
+ */
+BitReader::BitReader(const uint8_t* data, size_t length) : data(data), end(length) {}
+
+/**
+ * @brief constructor; reads the bits of a writer
+ * @param writer bitstream to read; has to stay valid and unchanged while the reader is used
+ */
+BitReader::BitReader(const BitWriter& writer) : data(writer.data()), end(writer.size()) {}
+
+BitReader::BitReader(const uint8_t* data, size_t begin, size_t end)
+    : data(data), begin(begin), end(end), pos(begin) {}
+
+/**
+ * @brief read a field of bits, LSB first, and advance
+ * @details bits behind the end of the stream are returned as zeros
+ * @param length number of bits, at most MAX_FIELD_BITS
+ * @return value of the field
+ */
+auto BitReader::read(int length) -> uint64_t {
+    uint64_t value = peek(length);
+    pos += length;
+    return value;
+}
+
+/**
+ * @brief read a single bit and advance
+ * @details bits behind the end of the stream are returned as zeros
+ * @return bit value
+ */
+auto BitReader::readBit() -> int {
+    int bit = 0;
+    if (pos < end) {
+        bit = (data[pos >> 3] >> (pos & (BYTE_SIZE - 1))) & 1;
+    }
+    pos++;
+    return bit;
+}
+
+/**
+ * @brief read a field of bits without advancing
+ * @param length number of bits, at most MAX_FIELD_BITS
+ * @return value of the field
+ */
+auto BitReader::peek(int length) const -> uint64_t {
+    if (pos >= end) {
+        return 0;
+    }
+    size_t available = end - pos;
+    if ((size_t)length > available) {
+        length = (int)available;
+    }
+    return (loadWord(pos) >> (pos & (BYTE_SIZE - 1))) & lowMask(length);
+}
+
+/**
+ * @brief advance without reading
+ * @param length number of bits to skip
+ */
+void BitReader::skip(size_t length) {
+    pos += length;
+}
+
+/**
+ * @brief set the read position
+ * @param pos bit index relative to the beginning of the reader
+ */
+void BitReader::seek(size_t pos) {
+    this->pos = begin + pos;
+}
+
+/**
+ * @brief return a reader for a section of this stream
+ * @param pos first bit of the section, relative to the beginning of the reader
+ * @param length number of bits of the section
+ * @return reader for the section
+ */
+auto BitReader::sub(size_t pos, size_t length) const -> BitReader {
+    size_t sub_begin = begin + pos;
+    size_t sub_end = sub_begin + length;
+    if (sub_end > end) {
+        sub_end = end;
+    }
+    if (sub_begin > sub_end) {
+        sub_begin = sub_end;
+    }
+    return {data, sub_begin, sub_end};
+}
+
+/**
+ * @brief return the read position
+ * @return bit index relative to the beginning of the reader
+ */
+auto BitReader::position() const -> size_t {
+    return pos - begin;
+}
+
+/**
+ * @brief return total number of bits
+ * @return number of bits
+ */
+auto BitReader::size() const -> size_t {
+    return end - begin;
+}
+
+/**
+ * @brief return number of bits left to read
+ * @return number of bits
+ */
+auto BitReader::remaining() const -> size_t {
+    return (pos < end) ? end - pos : 0;
+}
+
+/**
+ * @brief load up to 8 bytes starting at the byte containing the specified bit
+ * @param pos bit index
+ * @return little endian word
+ */
+auto BitReader::loadWord(size_t pos) const -> uint64_t {
+    size_t byte = pos >> 3;
+    size_t last = (end + BYTE_SIZE - 1) >> 3;
+    size_t count = last - byte;
+    if (count > sizeof(uint64_t)) {
+        count = sizeof(uint64_t);
+    }
+    uint64_t word = 0;
+    for (size_t i = 0; i < count; i++) {
+        word |= (uint64_t)data[byte + i] << (BYTE_SIZE * i);
+    }
+    return word;
+}
+
+}  // namespace VC_PWQ
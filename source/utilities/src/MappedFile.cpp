@@ -0,0 +1,173 @@
+//=======================================================================
+/** @file MappedFile.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Read-only memory mapping of a file. The decoders read the bits directly from the mapping, without copying the
+ * file; the pages are shared with other processes mapping the same file. Platforms without mmap read the file into
+ * memory instead.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/MappedFile.hpp"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define VC_PWQ_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace VC_PWQ {
+
+/**
+ * @brief constructor; maps the file
+ * @param name file name
+ */
+MappedFile::MappedFile(const std::string& name) {
+    open(name);
+}
+
+/**
+ * @brief destructor; unmaps the file
+ */
+MappedFile::~MappedFile() {
+    close();
+}
+
+/**
+ * @brief move constructor; takes over the mapping
+ */
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mapping(other.mapping), length(other.length), opened(other.opened), fallback(std::move(other.fallback)) {
+    if (!fallback.empty()) {
+        mapping = fallback.data();
+    }
+    other.mapping = nullptr;
+    other.length = 0;
+    other.opened = false;
+}
+
+/**
+ * @brief move assignment; takes over the mapping
+ */
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile& {
+    if (this != &other) {
+        close();
+        mapping = other.mapping;
+        length = other.length;
+        opened = other.opened;
+        fallback = std::move(other.fallback);
+        if (!fallback.empty()) {
+            mapping = fallback.data();
+        }
+        other.mapping = nullptr;
+        other.length = 0;
+        other.opened = false;
+    }
+    return *this;
+}
+
+/**
+ * @brief map a file read-only; a previously mapped file is closed
+ * @param name file name
+ * @return true if the file could be opened
+ */
+auto MappedFile::open(const std::string& name) -> bool {
+    close();
+
+#ifdef VC_PWQ_MMAP
+    int fd = ::open(name.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat info {};
+        if (fstat(fd, &info) == 0) {
+            length = (size_t)info.st_size;
+            opened = true;
+            if (length > 0) {
+                void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+                if (address != MAP_FAILED) {
+                    mapping = static_cast<const uint8_t*>(address);
+                }
+            }
+        }
+        ::close(fd);
+        if (!opened || mapping != nullptr || length == 0) {
+            return opened;
+        }
+        opened = false;
+    }
+#endif
+
+    // read the file, if it cannot be mapped
+    std::ifstream infile(name, std::ifstream::binary);
+    if (!infile.is_open()) {
+        length = 0;
+        return false;
+    }
+    infile.seekg(0, std::ifstream::end);
+    length = (size_t)infile.tellg();
+    infile.seekg(0);
+    fallback.resize(length);
+    infile.read(reinterpret_cast<char*>(fallback.data()), (std::streamsize)length);
+    mapping = fallback.data();
+    opened = true;
+    return true;
+}
+
+/**
+ * @brief unmap the file
+ */
+void MappedFile::close() {
+#ifdef VC_PWQ_MMAP
+    if (mapping != nullptr && fallback.empty()) {
+        munmap(const_cast<uint8_t*>(mapping), length);  // NOLINT
+    }
+#endif
+    fallback.clear();
+    fallback.shrink_to_fit();
+    mapping = nullptr;
+    length = 0;
+    opened = false;
+}
+
+/**
+ * @brief check if a file is open
+ * @return true if open
+ */
+auto MappedFile::isOpen() const -> bool {
+    return opened;
+}
+
+/**
+ * @brief content of the file
+ * @return pointer to the first byte; nullptr for empty files
+ */
+auto MappedFile::data() const -> const uint8_t* {
+    return mapping;
+}
+
+/**
+ * @brief size of the file
+ * @return size in bytes
+ */
+auto MappedFile::size() const -> size_t {
+    return length;
+}
+
+/**
+ * @brief bit reader over the whole file; valid as long as the file is mapped
+ * @return bit reader
+ */
+auto MappedFile::reader() const -> BitReader {
+    return {mapping, length * BYTE_SIZE};
+}
+
+}  // namespace VC_PWQ
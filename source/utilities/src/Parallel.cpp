@@ -0,0 +1,85 @@
+//=======================================================================
+/** @file Parallel.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Scheduling of independent tasks (e.g. files of a folder) on a number of worker threads. Idle workers take the next
+ * open task, so long and short tasks are balanced dynamically.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/Parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VC_PWQ {
+
+/**
+ * @brief determine the number of worker threads
+ * @param threads requested number of threads; 0 selects the number of hardware threads
+ * @param tasks number of tasks; no more workers than tasks are started
+ * @return number of worker threads, at least 1
+ */
+auto resolveThreads(int threads, size_t tasks) -> int {
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+    }
+    threads = (int)std::min((size_t)std::max(threads, 1), std::max(tasks, (size_t)1));
+    return threads;
+}
+
+/**
+ * @brief run body(task, worker) for every task in [0, tasks)
+ * @details the calling thread is worker 0; a worker owns its worker index for the whole run, so per-worker state (e.g.
+ * encoder instances) can be indexed by it without locking. If a task throws, the remaining tasks are skipped and the
+ * first exception is rethrown after all workers have finished.
+ * @param tasks number of tasks
+ * @param threads number of worker threads; 0 selects the number of hardware threads
+ * @param body function called for each task with the task and worker index
+ */
+void parallelFor(size_t tasks, int threads, const std::function<void(size_t task, int worker)>& body) {
+    int workers = resolveThreads(threads, tasks);
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto work = [&](int worker) {
+        for (size_t task = next++; task < tasks; task = next++) {
+            try {
+                body(task, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = tasks;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (int w = 1; w < workers; w++) {
+        pool.emplace_back(work, w);
+    }
+    work(0);
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace VC_PWQ
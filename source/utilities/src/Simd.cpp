@@ -0,0 +1,768 @@
+//=======================================================================
+/** @file Simd.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Vectorized kernels for the wavelet transform, quantization and block scans. The implementation is selected once at
+ * runtime (AVX2 on x86 if the CPU supports it, NEON on AArch64, scalar otherwise). All implementations evaluate the
+ * same operations in the same order, so the results are bit-identical.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/Simd.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VC_PWQ_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define VC_PWQ_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace VC_PWQ::Simd {
+
+namespace {
+
+//=======================================================================
+// scalar kernels
+
+void liftScalar(const double* in, double* out, int n, double h) {
+    out[0] = (out[0] + h * in[0]) + h * in[0];
+    for (int i = 1; i < n; i++) {
+        out[i] = (out[i] + h * in[i]) + h * in[i - 1];
+    }
+}
+
+void liftShiftScalar(const double* in, double* out, int n, double h) {
+    for (int i = 0; i < n - 1; i++) {
+        out[i] = (out[i] + h * in[i + 1]) + h * in[i];
+    }
+    out[n - 1] = (out[n - 1] + h * in[n - 1]) + h * in[n - 1];
+}
+
+void splitPredictTail(const double* data, double* even, double* odd, int start, int n_half, double h) {
+    for (int i = start; i < n_half - 1; i++) {
+        even[i] = data[2 * i];
+        odd[i] = (data[2 * i + 1] + h * data[2 * i + 2]) + h * data[2 * i];
+    }
+    int last = n_half - 1;
+    even[last] = data[2 * last];
+    odd[last] = (data[2 * last + 1] + h * data[2 * last]) + h * data[2 * last];
+}
+
+void splitPredictScalar(const double* data, double* even, double* odd, int n_half, double h) {
+    splitPredictTail(data, even, odd, 0, n_half, h);
+}
+
+void updateScaleTail(const double* even, const double* odd, double* data, int start, int n_half, double h, double s) {
+    if (start == 0) {
+        data[0] = ((even[0] + h * odd[0]) + h * odd[0]) * s;
+        data[n_half] = -odd[0] / s;
+        start = 1;
+    }
+    for (int i = start; i < n_half; i++) {
+        data[i] = ((even[i] + h * odd[i]) + h * odd[i - 1]) * s;
+        data[n_half + i] = -odd[i] / s;
+    }
+}
+
+void updateScaleScalar(const double* even, const double* odd, double* data, int n_half, double h, double s) {
+    updateScaleTail(even, odd, data, 0, n_half, h, s);
+}
+
+void unscaleUpdateTail(const double* data, double* even, double* odd, int start, int n_half, double h, double s) {
+    for (int i = start; i < n_half; i++) {
+        odd[i] = -data[n_half + i] * s;
+    }
+    if (start == 0) {
+        even[0] = (data[0] / s + h * odd[0]) + h * odd[0];
+        start = 1;
+    }
+    for (int i = start; i < n_half; i++) {
+        even[i] = (data[i] / s + h * odd[i]) + h * odd[i - 1];
+    }
+}
+
+void unscaleUpdateScalar(const double* data, double* even, double* odd, int n_half, double h, double s) {
+    unscaleUpdateTail(data, even, odd, 0, n_half, h, s);
+}
+
+void predictMergeTail(const double* even, const double* odd, double* data, int start, int n_half, double h) {
+    for (int i = start; i < n_half - 1; i++) {
+        data[2 * i] = even[i];
+        data[2 * i + 1] = (odd[i] + h * even[i + 1]) + h * even[i];
+    }
+    int last = n_half - 1;
+    data[2 * last] = even[last];
+    data[2 * last + 1] = (odd[last] + h * even[last]) + h * even[last];
+}
+
+void predictMergeScalar(const double* even, const double* odd, double* data, int n_half, double h) {
+    predictMergeTail(even, odd, data, 0, n_half, h);
+}
+
+auto quantizeValue(double in, double delta, double max_q) -> double {
+    double sign = (double)(0 < in) - (double)(in < 0);
+    double q = sign * delta * floor(std::abs(in) / delta + 0.5);  // NOLINT
+    if (std::abs(q) > max_q) {
+        return sign * max_q;
+    }
+    return q;
+}
+
+void quantizeScalar(const double* in, double* out, int length, double delta, double max_q) {
+    for (int i = 0; i < length; i++) {
+        out[i] = quantizeValue(in[i], delta, max_q);
+    }
+}
+
+void dequantizeScalar(const int* in, double* out, int length, double factor) {
+    for (int i = 0; i < length; i++) {
+        out[i] = (double)in[i] * factor;
+    }
+}
+
+auto absMaxScalar(const double* data, int length) -> double {
+    double max = 0;
+    for (int i = 0; i < length; i++) {
+        double temp = std::abs(data[i]);
+        if (temp > max) {
+            max = temp;
+        }
+    }
+    return max;
+}
+
+auto anyAboveScalar(const double* data, int length, double threshold) -> bool {
+    bool above = false;
+    for (int i = 0; i < length; i++) {
+        above |= std::abs(data[i]) > threshold;
+    }
+    return above;
+}
+
+//=======================================================================
+// AVX2 kernels; compiled for AVX2 only (no FMA), so products and sums are rounded separately like the scalar code
+
+#ifdef VC_PWQ_SIMD_AVX2
+
+static constexpr int AVX2_WIDTH = 4;
+static constexpr int EVEN_ORDER = 0xD8;  // lanes 0, 2, 1, 3
+static constexpr int LOW_HALVES = 0x20;
+static constexpr int HIGH_HALVES = 0x31;
+
+__attribute__((target("avx2"))) void liftAVX2(const double* in, double* out, int n, double h) {
+    out[0] = (out[0] + h * in[0]) + h * in[0];
+    __m256d hv = _mm256_set1_pd(h);
+    int i = 1;
+    for (; i + AVX2_WIDTH <= n; i += AVX2_WIDTH) {
+        __m256d o = _mm256_loadu_pd(out + i);
+        o = _mm256_add_pd(o, _mm256_mul_pd(hv, _mm256_loadu_pd(in + i)));
+        o = _mm256_add_pd(o, _mm256_mul_pd(hv, _mm256_loadu_pd(in + i - 1)));
+        _mm256_storeu_pd(out + i, o);
+    }
+    for (; i < n; i++) {
+        out[i] = (out[i] + h * in[i]) + h * in[i - 1];
+    }
+}
+
+__attribute__((target("avx2"))) void liftShiftAVX2(const double* in, double* out, int n, double h) {
+    __m256d hv = _mm256_set1_pd(h);
+    int i = 0;
+    for (; i + AVX2_WIDTH <= n - 1; i += AVX2_WIDTH) {
+        __m256d o = _mm256_loadu_pd(out + i);
+        o = _mm256_add_pd(o, _mm256_mul_pd(hv, _mm256_loadu_pd(in + i + 1)));
+        o = _mm256_add_pd(o, _mm256_mul_pd(hv, _mm256_loadu_pd(in + i)));
+        _mm256_storeu_pd(out + i, o);
+    }
+    for (; i < n - 1; i++) {
+        out[i] = (out[i] + h * in[i + 1]) + h * in[i];
+    }
+    out[n - 1] = (out[n - 1] + h * in[n - 1]) + h * in[n - 1];
+}
+
+/**
+ * @brief return the even samples of data[0..7]
+ */
+__attribute__((target("avx2"))) inline auto evenLanes(const double* data) -> __m256d {
+    __m256d lo = _mm256_unpacklo_pd(_mm256_loadu_pd(data), _mm256_loadu_pd(data + AVX2_WIDTH));
+    return _mm256_permute4x64_pd(lo, EVEN_ORDER);
+}
+
+/**
+ * @brief return the odd samples of data[0..7]
+ */
+__attribute__((target("avx2"))) inline auto oddLanes(const double* data) -> __m256d {
+    __m256d hi = _mm256_unpackhi_pd(_mm256_loadu_pd(data), _mm256_loadu_pd(data + AVX2_WIDTH));
+    return _mm256_permute4x64_pd(hi, EVEN_ORDER);
+}
+
+__attribute__((target("avx2"))) void splitPredictAVX2(const double* data,
+                                                      double* even,
+                                                      double* odd,
+                                                      int n_half,
+                                                      double h) {
+    __m256d hv = _mm256_set1_pd(h);
+    int i = 0;
+    // the next even samples are read up to data[2 * i + 9]
+    for (; i + AVX2_WIDTH + 1 <= n_half; i += AVX2_WIDTH) {
+        __m256d e = evenLanes(data + 2 * i);
+        __m256d e_next = evenLanes(data + 2 * i + 2);
+        __m256d o = oddLanes(data + 2 * i);
+        o = _mm256_add_pd(o, _mm256_mul_pd(hv, e_next));
+        o = _mm256_add_pd(o, _mm256_mul_pd(hv, e));
+        _mm256_storeu_pd(even + i, e);
+        _mm256_storeu_pd(odd + i, o);
+    }
+    splitPredictTail(data, even, odd, i, n_half, h);
+}
+
+__attribute__((target("avx2"))) void updateScaleAVX2(const double* even,
+                                                     const double* odd,
+                                                     double* data,
+                                                     int n_half,
+                                                     double h,
+                                                     double s) {
+    data[0] = ((even[0] + h * odd[0]) + h * odd[0]) * s;
+    data[n_half] = -odd[0] / s;
+    __m256d hv = _mm256_set1_pd(h);
+    __m256d sv = _mm256_set1_pd(s);
+    __m256d signmask = _mm256_set1_pd(-0.0);
+    int i = 1;
+    for (; i + AVX2_WIDTH <= n_half; i += AVX2_WIDTH) {
+        __m256d x1 = _mm256_loadu_pd(odd + i);
+        __m256d x0 = _mm256_loadu_pd(even + i);
+        x0 = _mm256_add_pd(x0, _mm256_mul_pd(hv, x1));
+        x0 = _mm256_add_pd(x0, _mm256_mul_pd(hv, _mm256_loadu_pd(odd + i - 1)));
+        _mm256_storeu_pd(data + i, _mm256_mul_pd(x0, sv));
+        _mm256_storeu_pd(data + n_half + i, _mm256_div_pd(_mm256_xor_pd(x1, signmask), sv));
+    }
+    updateScaleTail(even, odd, data, i, n_half, h, s);
+}
+
+__attribute__((target("avx2"))) void unscaleUpdateAVX2(const double* data,
+                                                       double* even,
+                                                       double* odd,
+                                                       int n_half,
+                                                       double h,
+                                                       double s) {
+    __m256d hv = _mm256_set1_pd(h);
+    __m256d sv = _mm256_set1_pd(s);
+    __m256d signmask = _mm256_set1_pd(-0.0);
+    int i = 0;
+    for (; i + AVX2_WIDTH <= n_half; i += AVX2_WIDTH) {
+        __m256d x1 = _mm256_xor_pd(_mm256_loadu_pd(data + n_half + i), signmask);
+        _mm256_storeu_pd(odd + i, _mm256_mul_pd(x1, sv));
+    }
+    for (; i < n_half; i++) {
+        odd[i] = -data[n_half + i] * s;
+    }
+    even[0] = (data[0] / s + h * odd[0]) + h * odd[0];
+    i = 1;
+    for (; i + AVX2_WIDTH <= n_half; i += AVX2_WIDTH) {
+        __m256d x0 = _mm256_div_pd(_mm256_loadu_pd(data + i), sv);
+        x0 = _mm256_add_pd(x0, _mm256_mul_pd(hv, _mm256_loadu_pd(odd + i)));
+        x0 = _mm256_add_pd(x0, _mm256_mul_pd(hv, _mm256_loadu_pd(odd + i - 1)));
+        _mm256_storeu_pd(even + i, x0);
+    }
+    for (; i < n_half; i++) {
+        even[i] = (data[i] / s + h * odd[i]) + h * odd[i - 1];
+    }
+}
+
+__attribute__((target("avx2"))) void predictMergeAVX2(const double* even,
+                                                      const double* odd,
+                                                      double* data,
+                                                      int n_half,
+                                                      double h) {
+    __m256d hv = _mm256_set1_pd(h);
+    int i = 0;
+    for (; i + AVX2_WIDTH <= n_half - 1; i += AVX2_WIDTH) {
+        __m256d e = _mm256_loadu_pd(even + i);
+        __m256d o = _mm256_loadu_pd(odd + i);
+        o = _mm256_add_pd(o, _mm256_mul_pd(hv, _mm256_loadu_pd(even + i + 1)));
+        o = _mm256_add_pd(o, _mm256_mul_pd(hv, e));
+        __m256d lo = _mm256_unpacklo_pd(e, o);
+        __m256d hi = _mm256_unpackhi_pd(e, o);
+        _mm256_storeu_pd(data + 2 * i, _mm256_permute2f128_pd(lo, hi, LOW_HALVES));
+        _mm256_storeu_pd(data + 2 * i + AVX2_WIDTH, _mm256_permute2f128_pd(lo, hi, HIGH_HALVES));
+    }
+    predictMergeTail(even, odd, data, i, n_half, h);
+}
+
+__attribute__((target("avx2"))) void quantizeAVX2(const double* in,
+                                                  double* out,
+                                                  int length,
+                                                  double delta,
+                                                  double max_q) {
+    __m256d dv = _mm256_set1_pd(delta);
+    __m256d mv = _mm256_set1_pd(max_q);
+    __m256d half = _mm256_set1_pd(0.5);  // NOLINT
+    __m256d signmask = _mm256_set1_pd(-0.0);
+    __m256d zero = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + AVX2_WIDTH <= length; i += AVX2_WIDTH) {
+        __m256d x = _mm256_loadu_pd(in + i);
+        __m256d mag = _mm256_andnot_pd(signmask, x);
+        __m256d q = _mm256_mul_pd(dv, _mm256_floor_pd(_mm256_add_pd(_mm256_div_pd(mag, dv), half)));
+        q = _mm256_blendv_pd(q, mv, _mm256_cmp_pd(q, mv, _CMP_GT_OQ));
+        // sign of the input; zero inputs give +0 like sgn()
+        q = _mm256_or_pd(q, _mm256_and_pd(x, signmask));
+        q = _mm256_andnot_pd(_mm256_cmp_pd(x, zero, _CMP_EQ_OQ), q);
+        _mm256_storeu_pd(out + i, q);
+    }
+    for (; i < length; i++) {
+        out[i] = quantizeValue(in[i], delta, max_q);
+    }
+}
+
+__attribute__((target("avx2"))) void dequantizeAVX2(const int* in, double* out, int length, double factor) {
+    __m256d fv = _mm256_set1_pd(factor);
+    int i = 0;
+    for (; i + AVX2_WIDTH <= length; i += AVX2_WIDTH) {
+        __m256d v = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(in + i)));
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(v, fv));
+    }
+    for (; i < length; i++) {
+        out[i] = (double)in[i] * factor;
+    }
+}
+
+__attribute__((target("avx2"))) auto absMaxAVX2(const double* data, int length) -> double {
+    __m256d signmask = _mm256_set1_pd(-0.0);
+    __m256d mv = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + AVX2_WIDTH <= length; i += AVX2_WIDTH) {
+        mv = _mm256_max_pd(mv, _mm256_andnot_pd(signmask, _mm256_loadu_pd(data + i)));
+    }
+    alignas(32) double lanes[AVX2_WIDTH];
+    _mm256_store_pd(lanes, mv);
+    double max = absMaxScalar(lanes, AVX2_WIDTH);
+    double tail = absMaxScalar(data + i, length - i);
+    return (tail > max) ? tail : max;
+}
+
+__attribute__((target("avx2"))) auto anyAboveAVX2(const double* data, int length, double threshold) -> bool {
+    __m256d signmask = _mm256_set1_pd(-0.0);
+    __m256d tv = _mm256_set1_pd(threshold);
+    __m256d above = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + AVX2_WIDTH <= length; i += AVX2_WIDTH) {
+        __m256d mag = _mm256_andnot_pd(signmask, _mm256_loadu_pd(data + i));
+        above = _mm256_or_pd(above, _mm256_cmp_pd(mag, tv, _CMP_GT_OQ));
+    }
+    return (_mm256_movemask_pd(above) != 0) || anyAboveScalar(data + i, length - i, threshold);
+}
+
+#endif /* VC_PWQ_SIMD_AVX2 */
+
+//=======================================================================
+// NEON kernels
+
+#ifdef VC_PWQ_SIMD_NEON
+
+static constexpr int NEON_WIDTH = 2;
+
+void liftNEON(const double* in, double* out, int n, double h) {
+    out[0] = (out[0] + h * in[0]) + h * in[0];
+    float64x2_t hv = vdupq_n_f64(h);
+    int i = 1;
+    for (; i + NEON_WIDTH <= n; i += NEON_WIDTH) {
+        float64x2_t o = vld1q_f64(out + i);
+        o = vaddq_f64(o, vmulq_f64(hv, vld1q_f64(in + i)));
+        o = vaddq_f64(o, vmulq_f64(hv, vld1q_f64(in + i - 1)));
+        vst1q_f64(out + i, o);
+    }
+    for (; i < n; i++) {
+        out[i] = (out[i] + h * in[i]) + h * in[i - 1];
+    }
+}
+
+void liftShiftNEON(const double* in, double* out, int n, double h) {
+    float64x2_t hv = vdupq_n_f64(h);
+    int i = 0;
+    for (; i + NEON_WIDTH <= n - 1; i += NEON_WIDTH) {
+        float64x2_t o = vld1q_f64(out + i);
+        o = vaddq_f64(o, vmulq_f64(hv, vld1q_f64(in + i + 1)));
+        o = vaddq_f64(o, vmulq_f64(hv, vld1q_f64(in + i)));
+        vst1q_f64(out + i, o);
+    }
+    for (; i < n - 1; i++) {
+        out[i] = (out[i] + h * in[i + 1]) + h * in[i];
+    }
+    out[n - 1] = (out[n - 1] + h * in[n - 1]) + h * in[n - 1];
+}
+
+void splitPredictNEON(const double* data, double* even, double* odd, int n_half, double h) {
+    float64x2_t hv = vdupq_n_f64(h);
+    int i = 0;
+    // the next even samples are read up to data[2 * i + 5]
+    for (; i + NEON_WIDTH + 1 <= n_half; i += NEON_WIDTH) {
+        float64x2x2_t pairs = vld2q_f64(data + 2 * i);
+        float64x2_t e_next = vld2q_f64(data + 2 * i + 2).val[0];
+        float64x2_t o = vaddq_f64(pairs.val[1], vmulq_f64(hv, e_next));
+        o = vaddq_f64(o, vmulq_f64(hv, pairs.val[0]));
+        vst1q_f64(even + i, pairs.val[0]);
+        vst1q_f64(odd + i, o);
+    }
+    splitPredictTail(data, even, odd, i, n_half, h);
+}
+
+void updateScaleNEON(const double* even, const double* odd, double* data, int n_half, double h, double s) {
+    data[0] = ((even[0] + h * odd[0]) + h * odd[0]) * s;
+    data[n_half] = -odd[0] / s;
+    float64x2_t hv = vdupq_n_f64(h);
+    float64x2_t sv = vdupq_n_f64(s);
+    int i = 1;
+    for (; i + NEON_WIDTH <= n_half; i += NEON_WIDTH) {
+        float64x2_t x1 = vld1q_f64(odd + i);
+        float64x2_t x0 = vaddq_f64(vld1q_f64(even + i), vmulq_f64(hv, x1));
+        x0 = vaddq_f64(x0, vmulq_f64(hv, vld1q_f64(odd + i - 1)));
+        vst1q_f64(data + i, vmulq_f64(x0, sv));
+        vst1q_f64(data + n_half + i, vdivq_f64(vnegq_f64(x1), sv));
+    }
+    updateScaleTail(even, odd, data, i, n_half, h, s);
+}
+
+void unscaleUpdateNEON(const double* data, double* even, double* odd, int n_half, double h, double s) {
+    float64x2_t hv = vdupq_n_f64(h);
+    float64x2_t sv = vdupq_n_f64(s);
+    int i = 0;
+    for (; i + NEON_WIDTH <= n_half; i += NEON_WIDTH) {
+        vst1q_f64(odd + i, vmulq_f64(vnegq_f64(vld1q_f64(data + n_half + i)), sv));
+    }
+    for (; i < n_half; i++) {
+        odd[i] = -data[n_half + i] * s;
+    }
+    even[0] = (data[0] / s + h * odd[0]) + h * odd[0];
+    i = 1;
+    for (; i + NEON_WIDTH <= n_half; i += NEON_WIDTH) {
+        float64x2_t x0 = vdivq_f64(vld1q_f64(data + i), sv);
+        x0 = vaddq_f64(x0, vmulq_f64(hv, vld1q_f64(odd + i)));
+        x0 = vaddq_f64(x0, vmulq_f64(hv, vld1q_f64(odd + i - 1)));
+        vst1q_f64(even + i, x0);
+    }
+    for (; i < n_half; i++) {
+        even[i] = (data[i] / s + h * odd[i]) + h * odd[i - 1];
+    }
+}
+
+void predictMergeNEON(const double* even, const double* odd, double* data, int n_half, double h) {
+    float64x2_t hv = vdupq_n_f64(h);
+    int i = 0;
+    for (; i + NEON_WIDTH <= n_half - 1; i += NEON_WIDTH) {
+        float64x2x2_t pairs;
+        pairs.val[0] = vld1q_f64(even + i);
+        float64x2_t o = vaddq_f64(vld1q_f64(odd + i), vmulq_f64(hv, vld1q_f64(even + i + 1)));
+        pairs.val[1] = vaddq_f64(o, vmulq_f64(hv, pairs.val[0]));
+        vst2q_f64(data + 2 * i, pairs);
+    }
+    predictMergeTail(even, odd, data, i, n_half, h);
+}
+
+void quantizeNEON(const double* in, double* out, int length, double delta, double max_q) {
+    float64x2_t dv = vdupq_n_f64(delta);
+    float64x2_t mv = vdupq_n_f64(max_q);
+    float64x2_t half = vdupq_n_f64(0.5);  // NOLINT
+    uint64x2_t signmask = vdupq_n_u64((uint64_t)1 << 63);  // NOLINT
+    int i = 0;
+    for (; i + NEON_WIDTH <= length; i += NEON_WIDTH) {
+        float64x2_t x = vld1q_f64(in + i);
+        float64x2_t q = vmulq_f64(dv, vrndmq_f64(vaddq_f64(vdivq_f64(vabsq_f64(x), dv), half)));
+        q = vbslq_f64(vcgtq_f64(q, mv), mv, q);
+        // sign of the input; zero inputs give +0 like sgn()
+        uint64x2_t bits = vorrq_u64(vreinterpretq_u64_f64(q), vandq_u64(vreinterpretq_u64_f64(x), signmask));
+        bits = vbicq_u64(bits, vceqzq_f64(x));
+        vst1q_f64(out + i, vreinterpretq_f64_u64(bits));
+    }
+    for (; i < length; i++) {
+        out[i] = quantizeValue(in[i], delta, max_q);
+    }
+}
+
+void dequantizeNEON(const int* in, double* out, int length, double factor) {
+    float64x2_t fv = vdupq_n_f64(factor);
+    int i = 0;
+    for (; i + NEON_WIDTH <= length; i += NEON_WIDTH) {
+        float64x2_t v = vcvtq_f64_s64(vmovl_s32(vld1_s32(in + i)));
+        vst1q_f64(out + i, vmulq_f64(v, fv));
+    }
+    for (; i < length; i++) {
+        out[i] = (double)in[i] * factor;
+    }
+}
+
+auto absMaxNEON(const double* data, int length) -> double {
+    float64x2_t mv = vdupq_n_f64(0);
+    int i = 0;
+    for (; i + NEON_WIDTH <= length; i += NEON_WIDTH) {
+        mv = vmaxq_f64(mv, vabsq_f64(vld1q_f64(data + i)));
+    }
+    double max = vmaxvq_f64(mv);
+    double tail = absMaxScalar(data + i, length - i);
+    return (tail > max) ? tail : max;
+}
+
+auto anyAboveNEON(const double* data, int length, double threshold) -> bool {
+    float64x2_t tv = vdupq_n_f64(threshold);
+    uint64x2_t above = vdupq_n_u64(0);
+    int i = 0;
+    for (; i + NEON_WIDTH <= length; i += NEON_WIDTH) {
+        above = vorrq_u64(above, vcgtq_f64(vabsq_f64(vld1q_f64(data + i)), tv));
+    }
+    return ((vgetq_lane_u64(above, 0) | vgetq_lane_u64(above, 1)) != 0) ||
+           anyAboveScalar(data + i, length - i, threshold);
+}
+
+#endif /* VC_PWQ_SIMD_NEON */
+
+//=======================================================================
+// dispatch
+
+struct Kernels {
+    Level level;
+    void (*lift)(const double*, double*, int, double);
+    void (*liftShift)(const double*, double*, int, double);
+    void (*splitPredict)(const double*, double*, double*, int, double);
+    void (*updateScale)(const double*, const double*, double*, int, double, double);
+    void (*unscaleUpdate)(const double*, double*, double*, int, double, double);
+    void (*predictMerge)(const double*, const double*, double*, int, double);
+    void (*quantize)(const double*, double*, int, double, double);
+    void (*dequantize)(const int*, double*, int, double);
+    auto (*absMax)(const double*, int) -> double;
+    auto (*anyAbove)(const double*, int, double) -> bool;
+};
+
+const Kernels SCALAR_KERNELS = {Level::SCALAR,
+                                liftScalar,
+                                liftShiftScalar,
+                                splitPredictScalar,
+                                updateScaleScalar,
+                                unscaleUpdateScalar,
+                                predictMergeScalar,
+                                quantizeScalar,
+                                dequantizeScalar,
+                                absMaxScalar,
+                                anyAboveScalar};
+
+#ifdef VC_PWQ_SIMD_AVX2
+const Kernels AVX2_KERNELS = {Level::AVX2,
+                              liftAVX2,
+                              liftShiftAVX2,
+                              splitPredictAVX2,
+                              updateScaleAVX2,
+                              unscaleUpdateAVX2,
+                              predictMergeAVX2,
+                              quantizeAVX2,
+                              dequantizeAVX2,
+                              absMaxAVX2,
+                              anyAboveAVX2};
+#endif
+
+#ifdef VC_PWQ_SIMD_NEON
+const Kernels NEON_KERNELS = {Level::NEON,
+                              liftNEON,
+                              liftShiftNEON,
+                              splitPredictNEON,
+                              updateScaleNEON,
+                              unscaleUpdateNEON,
+                              predictMergeNEON,
+                              quantizeNEON,
+                              dequantizeNEON,
+                              absMaxNEON,
+                              anyAboveNEON};
+#endif
+
+/**
+ * @brief return kernels for a level, nullptr if not supported
+ */
+auto kernelsFor(Level level) -> const Kernels* {
+    switch (level) {
+        case Level::SCALAR:
+            return &SCALAR_KERNELS;
+#ifdef VC_PWQ_SIMD_AVX2
+        case Level::AVX2:
+            return __builtin_cpu_supports("avx2") ? &AVX2_KERNELS : nullptr;
+#endif
+#ifdef VC_PWQ_SIMD_NEON
+        case Level::NEON:
+            return &NEON_KERNELS;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+auto active() -> const Kernels*& {
+    static const Kernels* kernels = kernelsFor(bestLevel());
+    return kernels;
+}
+
+}  // namespace
+
+/**
+ * @brief return the fastest kernel implementation supported by this CPU
+ * @return kernel level
+ */
+auto bestLevel() -> Level {
+#ifdef VC_PWQ_SIMD_AVX2
+    if (kernelsFor(Level::AVX2) != nullptr) {
+        return Level::AVX2;
+    }
+#endif
+#ifdef VC_PWQ_SIMD_NEON
+    return Level::NEON;
+#endif
+    return Level::SCALAR;
+}
+
+/**
+ * @brief return the kernel implementation currently used
+ * @return kernel level
+ */
+auto activeLevel() -> Level {
+    return active()->level;
+}
+
+/**
+ * @brief select the kernel implementation, e.g. to compare against the scalar kernels
+ * @details not thread-safe; has to be called while no kernel is running
+ * @param level kernel level
+ * @return false if the level is not supported, the selection is unchanged then
+ */
+auto setLevel(Level level) -> bool {
+    const Kernels* kernels = kernelsFor(level);
+    if (kernels == nullptr) {
+        return false;
+    }
+    active() = kernels;
+    return true;
+}
+
+/**
+ * @brief lifting step out[i] = (out[i] + h * in[i]) + h * in[i - 1], with in[-1] = in[0]
+ * @param in input coefficients
+ * @param out coefficients to update in place
+ * @param n number of coefficients
+ * @param h lifting coefficient
+ */
+void lift(const double* in, double* out, int n, double h) {
+    active()->lift(in, out, n, h);
+}
+
+/**
+ * @brief lifting step out[i] = (out[i] + h * in[i + 1]) + h * in[i], with in[n] = in[n - 1]
+ * @param in input coefficients
+ * @param out coefficients to update in place
+ * @param n number of coefficients
+ * @param h lifting coefficient
+ */
+void liftShift(const double* in, double* out, int n, double h) {
+    active()->liftShift(in, out, n, h);
+}
+
+/**
+ * @brief split a signal into even and odd samples and apply the first prediction step to the odd samples
+ * @param data signal of 2 * n_half samples
+ * @param even even samples, output
+ * @param odd predicted odd samples, output
+ * @param n_half number of even samples
+ * @param h lifting coefficient
+ */
+void splitPredict(const double* data, double* even, double* odd, int n_half, double h) {
+    active()->splitPredict(data, even, odd, n_half, h);
+}
+
+/**
+ * @brief apply the last update step to the even samples and scale both halves into data
+ * @details data[i] = lifted even[i] * scale, data[n_half + i] = -odd[i] / scale
+ * @param even even samples
+ * @param odd odd samples
+ * @param data output of 2 * n_half coefficients
+ * @param n_half number of even samples
+ * @param h lifting coefficient
+ * @param scale scaling factor
+ */
+void updateScale(const double* even, const double* odd, double* data, int n_half, double h, double scale) {
+    active()->updateScale(even, odd, data, n_half, h, scale);
+}
+
+/**
+ * @brief undo the scaling of both halves of data and apply the first inverse update step to the even samples
+ * @param data 2 * n_half coefficients
+ * @param even even samples, output
+ * @param odd odd samples, output
+ * @param n_half number of even samples
+ * @param h lifting coefficient
+ * @param scale scaling factor
+ */
+void unscaleUpdate(const double* data, double* even, double* odd, int n_half, double h, double scale) {
+    active()->unscaleUpdate(data, even, odd, n_half, h, scale);
+}
+
+/**
+ * @brief apply the last inverse prediction step to the odd samples and merge even and odd samples into data
+ * @param even even samples
+ * @param odd odd samples
+ * @param data output signal of 2 * n_half samples
+ * @param n_half number of even samples
+ * @param h lifting coefficient
+ */
+void predictMerge(const double* even, const double* odd, double* data, int n_half, double h) {
+    active()->predictMerge(even, odd, data, n_half, h);
+}
+
+/**
+ * @brief uniform midtread quantization with clipping, see uniformQuant
+ * @param in input values
+ * @param out quantized values, output
+ * @param length number of values
+ * @param delta quantization step size
+ * @param max_q largest quantized magnitude
+ */
+void quantize(const double* in, double* out, int length, double delta, double max_q) {
+    active()->quantize(in, out, length, delta, max_q);
+}
+
+/**
+ * @brief rescale integer values
+ * @param in integer values
+ * @param out rescaled values, output
+ * @param length number of values
+ * @param factor scaling factor
+ */
+void dequantize(const int* in, double* out, int length, double factor) {
+    active()->dequantize(in, out, length, factor);
+}
+
+/**
+ * @brief return absolute maximum value in array, 0 for an empty array
+ * @param data input array
+ * @param length number of values
+ * @return absolute maximum value
+ */
+auto absMax(const double* data, int length) -> double {
+    return active()->absMax(data, length);
+}
+
+/**
+ * @brief check if any absolute value in array is above a threshold
+ * @param data input array
+ * @param length number of values
+ * @param threshold threshold
+ * @return true if a value is above the threshold
+ */
+auto anyAbove(const double* data, int length, double threshold) -> bool {
+    return active()->anyAbove(data, length, threshold);
+}
+
+}  // namespace VC_PWQ::Simd
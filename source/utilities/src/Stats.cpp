@@ -0,0 +1,123 @@
+//=======================================================================
+/** @file Stats.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Accumulation and JSON export of the encoder and decoder statistics.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/Stats.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#include "../include/Bitstream.hpp"
+
+namespace VC_PWQ {
+
+namespace {
+
+// names of the contexts CONTEXT_SIDE ... CONTEXT_REFINEMENT
+const std::array<const char*, CONTEXTS> CONTEXT_NAMES = {
+    "side", "sign", "significance_0", "significance_1", "significance_2", "significance_3", "refinement"};
+
+}  // namespace
+
+/**
+ * @brief set all timings and counters to zero
+ */
+void Stats::reset() {
+    *this = Stats();
+}
+
+/**
+ * @brief add the timings and counters of another statistics object, e.g. of a worker thread
+ * @param other statistics to add
+ */
+void Stats::merge(const Stats& other) {
+    for (size_t s = 0; s < STAGES; s++) {
+        seconds[s] += other.seconds[s];
+    }
+    blocks += other.blocks;
+    bits += other.bits;
+    allocation_iterations += other.allocation_iterations;
+    for (size_t c = 0; c < CONTEXTS; c++) {
+        symbols[c] += other.symbols[c];
+    }
+    renormalizations += other.renormalizations;
+}
+
+/**
+ * @brief format the statistics as JSON object
+ * @details "enabled" is false if the library was built without VC_PWQ_STATS; all values are zero then
+ * @return JSON text
+ */
+auto Stats::toJSON() const -> std::string {
+    std::ostringstream out;
+    out.precision(9);  // NOLINT
+
+    out << "{\n  \"enabled\": " << (STATS_ENABLED ? "true" : "false") << ",\n";
+    out << "  \"seconds\": {";
+    for (size_t s = 0; s < STAGES; s++) {
+        out << (s == 0 ? "" : ", ") << "\"" << stageName((Stage)s) << "\": " << seconds[s];
+    }
+    out << "},\n";
+    out << "  \"blocks\": " << blocks << ",\n";
+    out << "  \"bits\": " << bits << ",\n";
+    out << "  \"bytes_per_block\": " << (blocks > 0 ? (double)bits / BYTE_SIZE / (double)blocks : 0.0) << ",\n";
+    out << "  \"allocation_iterations\": " << allocation_iterations << ",\n";
+    out << "  \"symbols\": {";
+    for (size_t c = 0; c < CONTEXTS; c++) {
+        out << (c == 0 ? "" : ", ") << "\"" << CONTEXT_NAMES[c] << "\": " << symbols[c];
+    }
+    out << "},\n";
+    out << "  \"renormalizations\": " << renormalizations << "\n}\n";
+    return out.str();
+}
+
+/**
+ * @brief name of a stage as used in the JSON export
+ * @param stage stage
+ * @return name in snake case
+ */
+auto stageName(Stage stage) -> const char* {
+    switch (stage) {
+        case Stage::DWT:
+            return "dwt";
+        case Stage::PSYCHOHAPTIC_MODEL:
+            return "psychohaptic_model";
+        case Stage::BIT_ALLOCATION:
+            return "bit_allocation";
+        case Stage::QUANTIZATION:
+            return "quantization";
+        case Stage::SPIHT:
+            return "spiht";
+        case Stage::ENTROPY_CODING:
+            return "entropy_coding";
+        case Stage::IO:
+            return "io";
+    }
+    return "";
+}
+
+/**
+ * @brief write statistics as JSON file
+ * @param stats statistics
+ * @param filename output file
+ * @return false if the file could not be written
+ */
+auto saveStats(const Stats& stats, const std::string& filename) -> bool {
+    std::ofstream file(filename);
+    if (!file) {
+        return false;
+    }
+    file << stats.toJSON();
+    return (bool)file;
+}
+
+}  // namespace VC_PWQ
@@ -0,0 +1,141 @@
+//=======================================================================
+/** @file StreamHeader.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * Optional stream header signalling coding tools beyond the original bitstream format. Streams without the header are
+ * decoded as before.
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/StreamHeader.hpp"
+
+namespace VC_PWQ {
+
+/**
+ * @brief write the stream header: magic number, version and flags
+ * @details the header is only needed if a flag is set; legacy streams are written without it
+ * @param header stream header
+ * @param bitstream bitstream to write to
+ */
+void writeStreamHeader(const StreamHeader& header, BitWriter& bitstream) {
+    bitstream.write(STREAM_MAGIC, STREAM_MAGIC_BITS);
+    bitstream.write(header.version, BYTE_SIZE);
+    bitstream.write(header.flags, BYTE_SIZE);
+}
+
+/**
+ * @brief read the stream header, if the stream starts with one
+ * @details the cursor is only advanced if a header with a known version is found; otherwise the header is reset to
+ * the legacy format
+ * @param bitstream read cursor at the beginning of the stream
+ * @param header stream header, output variable
+ * @return true if a header was found
+ */
+auto readStreamHeader(BitReader& bitstream, StreamHeader& header) -> bool {
+    header = StreamHeader();
+    if (bitstream.remaining() < (size_t)STREAM_HEADER_BITS || bitstream.peek(STREAM_MAGIC_BITS) != STREAM_MAGIC) {
+        return false;
+    }
+    BitReader cursor = bitstream;
+    cursor.skip(STREAM_MAGIC_BITS);
+    auto version = (int)cursor.read(BYTE_SIZE);
+    if (version < 1 || version > STREAM_VERSION) {
+        return false;
+    }
+    header.version = version;
+    header.flags = (uint32_t)cursor.read(BYTE_SIZE);
+    bitstream = cursor;
+    return true;
+}
+
+/**
+ * @brief write the container info of a seekable stream
+ * @param info container info
+ * @param bitstream bitstream to write to
+ */
+void writeContainerInfo(const ContainerInfo& info, BitWriter& bitstream) {
+    bitstream.write((uint32_t)info.fs, CONTAINER_FS_BITS);
+    bitstream.write(info.bl, CONTAINER_BL_BITS);
+    bitstream.write(info.channels, CONTAINER_CHANNELS_BITS);
+    bitstream.write(info.samples, CONTAINER_SAMPLES_BITS);
+}
+
+/**
+ * @brief read the container info of a seekable stream
+ * @param bitstream read cursor; advanced behind the container info
+ * @param info container info, output variable
+ * @return false if the stream ends within the container info or the values are invalid
+ */
+auto readContainerInfo(BitReader& bitstream, ContainerInfo& info) -> bool {
+    info.fs = (int)bitstream.read(CONTAINER_FS_BITS);
+    info.bl = (int)bitstream.read(CONTAINER_BL_BITS);
+    info.channels = (int)bitstream.read(CONTAINER_CHANNELS_BITS);
+    info.samples = (size_t)bitstream.read(CONTAINER_SAMPLES_BITS);
+    return bitstream.position() <= bitstream.size() && info.bl > 0 && info.channels > 0;
+}
+
+/**
+ * @brief write the slice index; the stream is padded to a full byte afterwards, so the first slice starts byte-aligned
+ * @param index slice index
+ * @param bitstream bitstream to write to
+ */
+void writeSliceIndex(const SliceIndex& index, BitWriter& bitstream) {
+    bitstream.write(index.slice_blocks, SLICE_BLOCKS_BITS);
+    bitstream.write(index.offsets.size(), SLICE_COUNT_BITS);
+    for (size_t offset : index.offsets) {
+        bitstream.write(offset, SLICE_OFFSET_BITS);
+    }
+    alignToByte(bitstream);
+}
+
+/**
+ * @brief read the slice index and skip the padding behind it
+ * @param bitstream read cursor; advanced to the first slice
+ * @param index slice index, output variable
+ * @return false if the index is inconsistent with the length of the stream
+ */
+auto readSliceIndex(BitReader& bitstream, SliceIndex& index) -> bool {
+    index.slice_blocks = (int)bitstream.read(SLICE_BLOCKS_BITS);
+    auto count = (size_t)bitstream.read(SLICE_COUNT_BITS);
+    if (count > bitstream.remaining() / SLICE_OFFSET_BITS) {
+        index.offsets.clear();
+        return false;
+    }
+    index.offsets.resize(count);
+    for (auto& offset : index.offsets) {
+        offset = (size_t)bitstream.read(SLICE_OFFSET_BITS);
+    }
+    alignToByte(bitstream);
+
+    size_t previous = 0;
+    for (size_t offset : index.offsets) {
+        if (offset < previous || offset * BYTE_SIZE > bitstream.remaining()) {
+            return false;
+        }
+        previous = offset;
+    }
+    return true;
+}
+
+/**
+ * @brief pad the bitstream with zeros to a multiple of 8 bits
+ * @param bitstream bitstream to write to
+ */
+void alignToByte(BitWriter& bitstream) {
+    bitstream.write(0, (int)((BYTE_SIZE - bitstream.size() % BYTE_SIZE) % BYTE_SIZE));
+}
+
+/**
+ * @brief advance the read cursor to the next multiple of 8 bits
+ * @param bitstream read cursor
+ */
+void alignToByte(BitReader& bitstream) {
+    bitstream.skip((BYTE_SIZE - bitstream.position() % BYTE_SIZE) % BYTE_SIZE);
+}
+
+}  // namespace VC_PWQ
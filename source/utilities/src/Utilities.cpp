@@ -13,6 +13,12 @@
 
 #include "../include/Utilities.hpp"
 
+#include <algorithm>
+#include <charconv>
+
+#include "../include/MappedFile.hpp"
+#include "../include/Simd.hpp"
+
 /**
  * @brief perform uniform quantization
  * @param in input signal
@@ -29,15 +35,7 @@ void VC_PWQ::uniformQuant(std::vector<double>& in,
                           int bits) {
     double delta = max / (1 << bits);
     double max_q = delta * ((1 << bits) - 1);
-    for (int i = start; i < start + length; i++) {
-        double sign = sgn(in[i]);
-        double q = sign * delta * floor(std::abs(in[i]) / delta + HALF_QUANT);
-        if (std::abs(q) > max_q) {
-            out[i] = sign * max_q;
-        } else {
-            out[i] = q;
-        }
-    }
+    Simd::quantize(in.data() + start, out.data() + start, length, delta, max_q);
 }
 
 auto VC_PWQ::uniformQuant(double& in, double max, int bits) -> double {
@@ -115,16 +113,7 @@ auto VC_PWQ::findMaxVector(std::vector<double>& data) -> double {
  * @return absolute maximum value of input array
  */
 auto VC_PWQ::findMax(std::vector<double>& data) -> double {
-    double max = 0;
-
-    for (const auto& d : data) {
-        double temp = std::abs(d);
-        if (temp > max) {
-            max = temp;
-        }
-    }
-
-    return max;
+    return Simd::absMax(data.data(), (int)data.size());
 }
 
 /**
@@ -221,57 +210,6 @@ auto VC_PWQ::energy(const std::vector<double>& in) -> double {
     return e;
 }
 
-/**
- * @brief convert decimal value (int) to binary number and add to bitstream
- * @param val input value
- * @param outstream bitstream to write to
- * @param length number of bits of binary number
- */
-void VC_PWQ::de2bi(int val, std::vector<char>* outstream, int length) {
-    if (val > (int)pow(2, (double)(length)) - 1) {
-        std::cout << "de2bi: value too large for bit size, value: " << val << ", bits: " << length
-                  << ", max: " << (int)pow(2, (double)(length)) - 1 << std::endl;
-    }
-    int n = length;
-    while (n > 0) {
-        outstream->push_back(val % 2);
-        val = val >> 1;
-        n--;
-    }
-}
-
-/**
- * @brief convert decimal value (int) to binary number and add to bitstream at specified position
- * @param val input value
- * @param outstream bitstream to write to
- * @param length number of bits of binary number
- * @param pos starting index in outstream
- */
-void VC_PWQ::de2bi(int val, std::vector<char>* outstream, int length, size_t pos) {
-    int n = length;
-    while (n > 0) {
-        outstream->at(pos) = val % 2;
-        val = val >> 1;
-        n--;
-        pos++;
-    }
-}
-
-/**
- * @brief convert binary number at specified position in stream to decimal number
- * @param pointer array of binary number
- * @param length number of bits of binary number
- * @param pos starting index in vector
- * @return decimal number (int)
- */
-auto VC_PWQ::bi2de(std::vector<char>* pointer, int length, size_t pos) -> int {
-    int val = 0;
-    for (int i = 0; i < length; i++) {
-        val += pointer->at(pos + i) << i;
-    }
-    return val;
-}
-
 /**
  * @brief convert binary number at specified position in stream to decimal number
  * @param pointer array of binary number
@@ -323,11 +261,15 @@ void VC_PWQ::saveMatrixScientific(const std::vector<std::vector<double>>& data,
     std::ofstream outFile(name, std::ofstream::out);
     std::scientific(outFile);
     if (outFile.is_open()) {
-        for (auto d : data) {
+        for (const auto& d : data) {
+            if (d.empty()) {
+                outFile << std::endl;
+                continue;
+            }
             for (auto it = d.begin(); it < d.end() - 1; ++it) {
                 outFile << (double)*it << delimiter;
             }
-            outFile << (double)*d.end() << std::endl;
+            outFile << (double)d.back() << std::endl;
         }
         outFile.close();
     } else {
@@ -335,54 +277,104 @@ void VC_PWQ::saveMatrixScientific(const std::vector<std::vector<double>>& data,
     }
 }
 
+/**
+ * @brief parse one number of a .txt file
+ * @details leading blanks and a leading '+' are skipped; a field that is not a number gives 0, like stream extraction
+ * @param begin start of the field
+ * @param end end of the line
+ * @param value parsed number
+ * @return position behind the number
+ */
+static auto parseNumber(const char* begin, const char* end, double& value) -> const char* {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) {
+        begin++;
+    }
+    const char* start = (begin < end && *begin == '+') ? begin + 1 : begin;
+    auto [ptr, ec] = std::from_chars(start, end, value);
+    if (ec != std::errc()) {
+        value = 0;
+        return begin;
+    }
+    return ptr;
+}
+
+/**
+ * @brief read matrix from .txt file
+ * @details the file is memory-mapped and parsed in place; the delimiter (',', tab or blanks) is detected from the first
+ * non-empty line. The values are stored per column, which is the layout of files with one channel per column. Files
+ * with more columns than rows hold one channel per row and are transposed. Missing values of a row are set to 0, a
+ * row with more values than the rows before widens the matrix with 0 padded columns and empty lines are skipped.
+ * @param buffer output matrix, one vector per channel
+ * @param name file name
+ * @return 1 if the file could be read, 0 otherwise
+ */
 auto VC_PWQ::readTXTMatrix(std::vector<std::vector<double>>& buffer, const std::string& name) -> int {
+    buffer.clear();
     if (!std::filesystem::is_regular_file(std::filesystem::path(name))) {
         return 0;
     }
-    std::ifstream inFile;
-    inFile.open(name, std::ifstream::in);
-    std::string line;
-    buffer.clear();
-    while (getline(inFile, line))  // for multiple rows
-    {
-        std::string delimiter;
-        if (line.find(',') != std::string::npos) {
-            delimiter = ",";
-        } else if (line.find('\t') != std::string::npos) {
-            delimiter = "\t";
-        } else {
-            delimiter = " ";
+    const MappedFile file(name);
+    if (file.size() == 0) {
+        return 0;
+    }
+    const char* pos = reinterpret_cast<const char*>(file.data());
+    const char* end = pos + file.size();
+
+    char delimiter = ' ';
+    size_t rows = 0;
+    while (pos < end) {
+        const char* line_end = std::find(pos, end, '\n');
+        const char* next = (line_end < end) ? line_end + 1 : end;
+        while (line_end > pos && (line_end[-1] == '\r' || line_end[-1] == ' ' || line_end[-1] == '\t')) {
+            line_end--;
         }
-        std::vector<double> buffer_line;
-        while (line.compare(" ") == 1) {
-            line = line.substr(1, line.size() - 1);
+        if (line_end == pos) {
+            pos = next;
+            continue;
         }
-        size_t pos = 0;
-        pos = line.find(delimiter);
-        while (pos <= line.size()) {
-            std::string substring = line.substr(0, pos);
-
-            std::istringstream os(substring);
-            double d = 0;
-            os >> d;  // scientific notation as input works
-            buffer_line.push_back(d);
-
-            line = line.substr(pos + 1, line.size() - 1);
-            while (line.compare(" ") == 1) {
-                line = line.substr(1, line.size() - 1);
+        if (rows == 0) {
+            if (std::find(pos, line_end, ',') != line_end) {
+                delimiter = ',';
+            } else if (std::find(pos, line_end, '\t') != line_end) {
+                delimiter = '\t';
             }
+        }
 
-            pos = line.find(delimiter);
+        size_t column = 0;
+        while (true) {
+            double value = 0;
+            pos = parseNumber(pos, line_end, value);
+            if (column == buffer.size()) {
+                buffer.emplace_back(rows, 0.0);
+            }
+            buffer[column].push_back(value);
+            column++;
+
+            if (delimiter == ' ') {
+                pos = std::find_if(pos, line_end, [](char c) { return c == ' ' || c == '\t'; });
+                pos = std::find_if(pos, line_end, [](char c) { return c != ' ' && c != '\t'; });
+                if (pos == line_end) {
+                    break;
+                }
+            } else {
+                pos = std::find(pos, line_end, delimiter);
+                if (pos == line_end) {
+                    break;
+                }
+                pos++;
+            }
+        }
+        for (; column < buffer.size(); column++) {
+            buffer[column].push_back(0);
         }
+        rows++;
+        pos = next;
+    }
 
-        std::istringstream os(line);
-        double d = 0;
-        os >> d;  // scientific notation as input works
-        buffer_line.push_back(d);
-        buffer.push_back(buffer_line);
+    if (rows == 0) {
+        return 0;
     }
-    if (buffer.size() > buffer[0].size()) {
-        std::cout << "transposing input data" << std::endl;
+    if (rows <= buffer.size()) {
         buffer = transposeMatrix(buffer);
     }
     return 1;
@@ -410,36 +402,44 @@ auto VC_PWQ::bitget(int in, int bit) -> int {
  * @return boolean is true if the signal only contains zeros
  */
 auto VC_PWQ::checkZeros(std::vector<double>& sig, int length) -> bool {
-    bool zero = true;
-    for (int i = 0; i < length; i++) {
-        if (std::abs(sig[i]) > 1e-10) {
-            zero = false;
+    return !Simd::anyAbove(sig.data(), length, 1e-10);  // NOLINT
+}
+
+/**
+ * @brief copy a block window of a channel
+ * @details samples behind the end of the channel are set to zero
+ * @param channel channel to read from
+ * @param start index of the first sample of the block
+ * @param block output buffer; its size defines the block length
+ */
+void VC_PWQ::copyBlock(const ChannelView& channel, size_t start, std::vector<double>& block) {
+    size_t i = 0;
+    if (start < channel.length) {
+        size_t count = std::min(block.size(), channel.length - start);
+        // index per sample, so no pointer is formed behind the last sample of a strided channel
+        const double* in = channel.data + start * channel.stride;
+        for (; i < count; i++) {
+            block[i] = in[i * channel.stride];
         }
     }
-    return zero;
+    for (; i < block.size(); i++) {
+        block[i] = 0;
+    }
 }
 
 /**
  * @brief load binary file
  * @param name filename
- * @param bitstream buffer to write to
+ * @param data buffer to write the packed bits to
  */
-void VC_PWQ::loadBinary(const std::string& name, std::vector<char>& bitstream) {
+void VC_PWQ::loadBinary(const std::string& name, std::vector<uint8_t>& data) {
     std::ifstream infile(name, std::ifstream::binary);
     if (infile.is_open()) {
         infile.seekg(0, infile.end);
         size_t size = infile.tellg();
         infile.seekg(0);
-        bitstream.reserve(size);
-        for (size_t i = 0; i < size; i++) {
-            char data;
-            infile.read(&data, 1);
-            auto data_long = (unsigned long)data;
-            std::bitset<BYTE_SIZE> data_bits(data_long);
-            for (int i = 0; i < BYTE_SIZE; i++) {
-                bitstream.push_back((char)data_bits[i]);
-            }
-        }
+        data.resize(size);
+        infile.read(reinterpret_cast<char*>(data.data()), (std::streamsize)size);
         infile.close();
     }
 }
@@ -449,28 +449,27 @@ void VC_PWQ::loadBinary(const std::string& name, std::vector<char>& bitstream) {
  * @param name filename
  * @param bitstream buffer to get data from
  */
-void VC_PWQ::saveAsBinary(const std::string& name, std::vector<char>& bitstream) {
-    size_t j = 0;
-    size_t out_length = bitstream.size();
+void VC_PWQ::saveAsBinary(const std::string& name, const BitWriter& bitstream) {
     std::ofstream outfile(name, std::ofstream::binary);
-    bool go_on = true;
-    while (go_on) {
-        std::bitset<BYTE_SIZE> bits;
-        for (int i = 0; i < BYTE_SIZE; i++) {
-            bits[i] = bitstream.at(j);
-            j++;
-            if (j >= out_length) {
-                go_on = false;
-                break;
-            }
-        }
-        unsigned long bits_long = bits.to_ulong();
-        char bits_char = static_cast<char>(bits_long);
-        outfile.write(&bits_char, 1);
-    }
+    outfile.write(reinterpret_cast<const char*>(bitstream.data()), (std::streamsize)bitstream.sizeBytes());
     outfile.close();
 }
 
+/**
+ * @brief save bitstream to a caller-supplied memory buffer, in the same layout as the .binary files
+ * @param bitstream buffer to get data from
+ * @param out destination buffer
+ * @param capacity size of the destination buffer in bytes; needs at least bitstream.sizeBytes()
+ * @return false if the destination buffer is too small (nothing is written then)
+ */
+auto VC_PWQ::saveToBuffer(const BitWriter& bitstream, uint8_t* out, size_t capacity) -> bool {
+    if (capacity < bitstream.sizeBytes()) {
+        return false;
+    }
+    std::copy(bitstream.data(), bitstream.data() + bitstream.sizeBytes(), out);
+    return true;
+}
+
 auto VC_PWQ::transposeMatrix(const std::vector<std::vector<double>>& in) -> std::vector<std::vector<double>> {
     std::vector<std::vector<double>> out;
     out.reserve(in[0].size());
@@ -0,0 +1,125 @@
+//=======================================================================
+/** @file Bitstream.test.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/Bitstream.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+using VC_PWQ::BitReader;
+using VC_PWQ::BitWriter;
+
+TEST_CASE("BitWriter") {
+
+    SECTION("bits are packed LSB first") {
+        BitWriter writer;
+        writer.writeBit(1);
+        writer.writeBit(0);
+        writer.writeBit(1);
+        writer.write(0x1F, 5);  // NOLINT
+        writer.writeBit(1);
+        REQUIRE(writer.size() == 9);
+        REQUIRE(writer.sizeBytes() == 2);
+        CHECK(writer.data()[0] == 0xFD);
+        CHECK(writer.data()[1] == 0x01);
+        CHECK(writer.at(1) == 0);
+        CHECK(writer.at(8) == 1);
+    }
+
+    SECTION("truncate and append") {
+        BitWriter block;
+        block.write(0x3FF, 10);  // NOLINT
+        block.resize(7);         // NOLINT
+        CHECK(block.size() == 7);
+        CHECK(block.data()[0] == 0x7F);
+
+        BitWriter stream;
+        stream.write(0, 3);  // NOLINT
+        stream.append(block, 5);
+        CHECK(stream.size() == 8);
+        CHECK(stream.data()[0] == 0xF8);
+    }
+
+    SECTION("bulk append matches bitwise append at every offset") {
+        BitWriter source;
+        for (uint64_t i = 0; i < 40; i++) {              // NOLINT
+            source.write(i * 0x9E3779B97F4A7C15ULL, 7);  // NOLINT
+        }
+        for (int offset = 0; offset < VC_PWQ::BYTE_SIZE; offset++) {
+            for (size_t length : {0UL, 1UL, 7UL, 8UL, 9UL, 64UL, 201UL, 280UL}) {  // NOLINT
+                BitWriter bulk;
+                bulk.write(0x55, offset);  // NOLINT
+                BitWriter bitwise = bulk;
+                bulk.append(source, length);
+                for (size_t i = 0; i < length; i++) {
+                    bitwise.writeBit(source.at(i));
+                }
+                REQUIRE(bulk.size() == bitwise.size());
+                CHECK(std::equal(bulk.data(), bulk.data() + bulk.sizeBytes(), bitwise.data()));
+            }
+        }
+    }
+
+    SECTION("complete bytes are removed from the front") {
+        BitWriter writer;
+        writer.write(0xABCD, 16);  // NOLINT
+        writer.write(0x5, 3);      // NOLINT
+        writer.discardBytes(1);
+        CHECK(writer.size() == 11);
+        CHECK(writer.data()[0] == 0xAB);
+        CHECK(writer.data()[1] == 0x05);
+        writer.discardBytes(5);  // NOLINT
+        CHECK(writer.size() == 3);
+        writer.write(0x1F, 5);  // NOLINT
+        CHECK(writer.data()[0] == 0xFD);
+    }
+}
+
+TEST_CASE("BitReader") {
+
+    SECTION("fields written are read back") {
+        BitWriter writer;
+        uint64_t value = 1;
+        for (int length = 1; length <= VC_PWQ::MAX_FIELD_BITS; length++) {
+            writer.write(value, length);
+            value = (value << 1) | (uint64_t)(length & 1);
+        }
+
+        BitReader reader(writer);
+        value = 1;
+        for (int length = 1; length <= VC_PWQ::MAX_FIELD_BITS; length++) {
+            CHECK(reader.read(length) == value);
+            value = (value << 1) | (uint64_t)(length & 1);
+        }
+        CHECK(reader.remaining() == 0);
+    }
+
+    SECTION("bits behind the end are zero") {
+        std::vector<uint8_t> data = {0xFF, 0xFF};
+        BitReader reader(data.data(), 12);  // NOLINT
+        CHECK(reader.read(10) == 0x3FF);    // NOLINT
+        CHECK(reader.read(4) == 0x3);
+        CHECK(reader.readBit() == 0);
+        CHECK(reader.remaining() == 0);
+    }
+
+    SECTION("section of a stream") {
+        std::vector<uint8_t> data = {0xF0, 0x0F};
+        BitReader reader(data.data(), 16);  // NOLINT
+        BitReader section = reader.sub(4, 8);
+        CHECK(section.size() == 8);
+        CHECK(section.read(8) == 0xFF);
+        CHECK(section.readBit() == 0);
+    }
+}
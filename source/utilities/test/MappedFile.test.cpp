@@ -0,0 +1,65 @@
+//=======================================================================
+/** @file MappedFile.test.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/MappedFile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include "../include/Utilities.hpp"
+
+TEST_CASE("MappedFile") {
+
+    const std::string name = (std::filesystem::temp_directory_path() / "vcpwq_mappedfile.binary").string();
+
+    SECTION("content matches the written bitstream") {
+        VC_PWQ::BitWriter bits;
+        for (uint32_t i = 0; i < 1000; i++) {  // NOLINT
+            bits.write(i * 2654435761U, 13);   // NOLINT
+        }
+        VC_PWQ::saveAsBinary(name, bits);
+
+        VC_PWQ::MappedFile file(name);
+        REQUIRE(file.isOpen());
+        REQUIRE(file.size() == bits.sizeBytes());
+        CHECK(std::equal(file.data(), file.data() + file.size(), bits.data()));
+
+        VC_PWQ::BitReader reader = file.reader();
+        for (uint32_t i = 0; i < 1000; i++) {                        // NOLINT
+            CHECK(reader.read(13) == ((i * 2654435761U) & 0x1FFFU));  // NOLINT
+        }
+
+        VC_PWQ::MappedFile moved(std::move(file));
+        CHECK(!file.isOpen());
+        CHECK(moved.size() == bits.sizeBytes());
+        CHECK(std::equal(moved.data(), moved.data() + moved.size(), bits.data()));
+    }
+
+    SECTION("empty and missing files") {
+        VC_PWQ::saveAsBinary(name, VC_PWQ::BitWriter());
+        VC_PWQ::MappedFile file(name);
+        CHECK(file.isOpen());
+        CHECK(file.size() == 0);
+        CHECK(file.reader().size() == 0);
+
+        std::remove(name.c_str());
+        CHECK(!file.open(name));
+        CHECK(!file.isOpen());
+    }
+
+    std::remove(name.c_str());
+}
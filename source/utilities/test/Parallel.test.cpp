@@ -0,0 +1,56 @@
+//=======================================================================
+/** @file Parallel.test.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/Parallel.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("parallelFor") {
+
+    SECTION("every task runs exactly once") {
+        for (int threads : {1, 3, 0}) {
+            std::vector<std::atomic<int>> runs(97);  // NOLINT
+            VC_PWQ::parallelFor(runs.size(), threads, [&](size_t task, int /*worker*/) { runs[task]++; });
+            for (const auto& r : runs) {
+                CHECK(r == 1);
+            }
+        }
+    }
+
+    SECTION("worker indices are within the resolved thread count") {
+        const size_t tasks = 40;
+        int workers = VC_PWQ::resolveThreads(4, tasks);
+        REQUIRE(workers == 4);
+        std::atomic<bool> valid(true);
+        VC_PWQ::parallelFor(tasks, 4, [&](size_t /*task*/, int worker) {
+            if (worker < 0 || worker >= workers) {
+                valid = false;
+            }
+        });
+        CHECK(valid);
+        CHECK(VC_PWQ::resolveThreads(8, 2) == 2);
+        CHECK(VC_PWQ::resolveThreads(0, 1) == 1);
+    }
+
+    SECTION("exceptions are passed to the caller") {
+        CHECK_THROWS_AS(VC_PWQ::parallelFor(10, 2,
+                                            [](size_t task, int /*worker*/) {
+                                                if (task == 5) {
+                                                    throw std::runtime_error("task failed");
+                                                }
+                                            }),
+                        std::runtime_error);
+    }
+}
@@ -0,0 +1,134 @@
+//=======================================================================
+/** @file Simd.test.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+using VC_PWQ::Simd::Level;
+
+namespace {
+
+/**
+ * @brief run a kernel with the scalar and the best implementation and require bit-identical outputs
+ */
+void compareLevels(const std::function<void(std::vector<double>&)>& kernel, size_t size) {
+    std::vector<double> scalar(size, 0);
+    std::vector<double> vectorized(size, 0);
+
+    REQUIRE(VC_PWQ::Simd::setLevel(Level::SCALAR));
+    kernel(scalar);
+    REQUIRE(VC_PWQ::Simd::setLevel(VC_PWQ::Simd::bestLevel()));
+    kernel(vectorized);
+
+    CHECK(std::memcmp(scalar.data(), vectorized.data(), size * sizeof(double)) == 0);
+}
+
+auto testSignal(int length) -> std::vector<double> {
+    std::vector<double> sig(length);
+    for (int i = 0; i < length; i++) {
+        sig[i] = sin(0.37 * i) * (1 + i % 5) - 0.25 * cos(1.9 * i);  // NOLINT
+    }
+    if (length > 4) {
+        sig[3] = 0;     // NOLINT
+        sig[4] = -0.0;  // NOLINT
+    }
+    return sig;
+}
+
+}  // namespace
+
+TEST_CASE("Simd kernels match scalar kernels") {
+
+    static constexpr double h = -1.5861343420693648;
+    static constexpr double scale = 1.1496043988602418;
+
+    // odd lengths exercise the scalar tails of the vector loops
+    for (int n : {1, 2, 3, 5, 8, 13, 64}) {
+        std::vector<double> sig = testSignal(2 * n);
+
+        SECTION("lifting steps, n = " + std::to_string(n)) {
+            compareLevels(
+                [&](std::vector<double>& out) {
+                    std::copy(sig.begin(), sig.begin() + n, out.begin());
+                    VC_PWQ::Simd::lift(sig.data() + n, out.data(), n, h);
+                    VC_PWQ::Simd::liftShift(sig.data() + n, out.data(), n, h);
+                },
+                n);
+        }
+
+        SECTION("split and merge, n = " + std::to_string(n)) {
+            compareLevels(
+                [&](std::vector<double>& out) {
+                    std::vector<double> scratch(2 * n);
+                    VC_PWQ::Simd::splitPredict(sig.data(), scratch.data(), scratch.data() + n, n, h);
+                    VC_PWQ::Simd::updateScale(scratch.data(), scratch.data() + n, out.data(), n, h, scale);
+                    VC_PWQ::Simd::unscaleUpdate(out.data(), scratch.data(), scratch.data() + n, n, -h, scale);
+                    VC_PWQ::Simd::predictMerge(scratch.data(), scratch.data() + n, out.data(), n, -h);
+                },
+                2 * n);
+        }
+
+        SECTION("quantization, n = " + std::to_string(n)) {
+            compareLevels(
+                [&](std::vector<double>& out) {
+                    VC_PWQ::Simd::quantize(sig.data(), out.data(), 2 * n, 0.125, 2.5);  // NOLINT
+                },
+                2 * n);
+
+            std::vector<int> ints(2 * n);
+            for (int i = 0; i < 2 * n; i++) {
+                ints[i] = (i * 7919) % 201 - 100;  // NOLINT
+            }
+            compareLevels(
+                [&](std::vector<double>& out) {
+                    VC_PWQ::Simd::dequantize(ints.data(), out.data(), 2 * n, 0.03125);  // NOLINT
+                },
+                2 * n);
+        }
+
+        SECTION("block scans, n = " + std::to_string(n)) {
+            compareLevels([&](std::vector<double>& out) { out[0] = VC_PWQ::Simd::absMax(sig.data(), 2 * n); }, 1);
+            compareLevels(
+                [&](std::vector<double>& out) {
+                    out[0] = VC_PWQ::Simd::anyAbove(sig.data(), 2 * n, 3.5) ? 1 : 0;  // NOLINT
+                },
+                1);
+        }
+    }
+
+    VC_PWQ::Simd::setLevel(VC_PWQ::Simd::bestLevel());
+}
+
+TEST_CASE("Simd quantization") {
+
+    SECTION("sign handling and clipping") {
+        std::vector<double> in = {0.0, -0.0, 0.01, -0.01, 0.3, -0.3, 10, -10};  // NOLINT
+        std::vector<double> out(in.size());
+        VC_PWQ::Simd::quantize(in.data(), out.data(), (int)in.size(), 0.25, 0.75);  // NOLINT
+
+        CHECK(out[0] == 0);
+        CHECK(!std::signbit(out[1]));
+        CHECK(out[2] == 0);
+        CHECK(std::signbit(out[3]));
+        CHECK(out[4] == 0.25);
+        CHECK(out[5] == -0.25);
+        CHECK(out[6] == 0.75);
+        CHECK(out[7] == -0.75);
+    }
+}
@@ -0,0 +1,72 @@
+//=======================================================================
+/** @file Stats.test.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/Stats.hpp"
+
+#include <string>
+
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("Stats") {
+
+    SECTION("merge adds all counters and reset clears them") {
+        VC_PWQ::Stats a;
+        VC_PWQ::Stats b;
+        a.seconds[(size_t)VC_PWQ::Stage::DWT] = 1.5;  // NOLINT
+        b.seconds[(size_t)VC_PWQ::Stage::DWT] = 0.5;  // NOLINT
+        a.blocks = 2;  // NOLINT
+        b.blocks = 3;  // NOLINT
+        b.bits = 800;  // NOLINT
+        b.symbols[VC_PWQ::CONTEXT_REFINEMENT] = 7;  // NOLINT
+        b.renormalizations = 11;  // NOLINT
+
+        a.merge(b);
+        CHECK(a.seconds[(size_t)VC_PWQ::Stage::DWT] == 2.0);
+        CHECK(a.blocks == 5);
+        CHECK(a.bits == 800);
+        CHECK(a.symbols[VC_PWQ::CONTEXT_REFINEMENT] == 7);
+        CHECK(a.renormalizations == 11);
+
+        a.reset();
+        CHECK(a.blocks == 0);
+        CHECK(a.bits == 0);
+        CHECK(a.seconds[(size_t)VC_PWQ::Stage::DWT] == 0.0);
+    }
+
+    SECTION("counters are only recorded with VC_PWQ_STATS") {
+        VC_PWQ::Stats stats;
+        stats.addBlock(64);  // NOLINT
+        stats.addAllocationIterations(3);
+        VC_PWQ::countSymbol(&stats, VC_PWQ::CONTEXT_SIGN);
+        VC_PWQ::countSymbol(nullptr, VC_PWQ::CONTEXT_SIGN);
+        VC_PWQ::countRenormalization(&stats);
+
+        const uint64_t expected = VC_PWQ::STATS_ENABLED ? 1 : 0;
+        CHECK(stats.blocks == expected);
+        CHECK(stats.bits == expected * 64);
+        CHECK(stats.allocation_iterations == expected * 3);
+        CHECK(stats.symbols[VC_PWQ::CONTEXT_SIGN] == expected);
+        CHECK(stats.renormalizations == expected);
+    }
+
+    SECTION("JSON contains every stage and context") {
+        VC_PWQ::Stats stats;
+        stats.blocks = 2;  // NOLINT
+        stats.bits = 160;  // NOLINT
+        const std::string json = stats.toJSON();
+        CHECK(json.find("\"enabled\"") != std::string::npos);
+        for (size_t s = 0; s < VC_PWQ::STAGES; s++) {
+            CHECK(json.find(VC_PWQ::stageName((VC_PWQ::Stage)s)) != std::string::npos);
+        }
+        CHECK(json.find("\"refinement\"") != std::string::npos);
+        CHECK(json.find("\"bytes_per_block\": 10") != std::string::npos);
+    }
+}
@@ -0,0 +1,118 @@
+//=======================================================================
+/** @file StreamHeader.test.cpp
+ *  @author Andreas Noll, Lars Nockenberg
+ *
+ * This file is part of the 'VC-PWQ' library
+ *
+ * (c) 2023. This work is licensed under a CC BY-NC 3.0 license.
+ *
+ */
+//=======================================================================
+
+#include "../include/StreamHeader.hpp"
+
+#include <catch2/catch_all.hpp>
+
+using VC_PWQ::BitReader;
+using VC_PWQ::BitWriter;
+using VC_PWQ::EntropyCoder;
+using VC_PWQ::StreamHeader;
+
+TEST_CASE("StreamHeader") {
+
+    SECTION("header is read back and the cursor is advanced") {
+        StreamHeader header;
+        header.flags |= VC_PWQ::FLAG_RANGE_CODER;
+        BitWriter writer;
+        VC_PWQ::writeStreamHeader(header, writer);
+        writer.write(0x2A, 6);  // NOLINT
+        REQUIRE(writer.size() == VC_PWQ::STREAM_HEADER_BITS + 6);
+
+        BitReader reader(writer);
+        StreamHeader read;
+        REQUIRE(VC_PWQ::readStreamHeader(reader, read));
+        CHECK(read.version == VC_PWQ::STREAM_VERSION);
+        CHECK(!read.isLegacy());
+        CHECK(read.entropyCoder() == EntropyCoder::RANGE);
+        CHECK(reader.read(6) == 0x2A);  // NOLINT
+    }
+
+    SECTION("streams without header are left untouched") {
+        BitWriter writer;
+        writer.write(0x3, 4);  // NOLINT
+        writer.write(0, VC_PWQ::STREAM_HEADER_BITS);
+
+        BitReader reader(writer);
+        StreamHeader read;
+        read.flags = VC_PWQ::FLAG_RANGE_CODER;
+        CHECK(!VC_PWQ::readStreamHeader(reader, read));
+        CHECK(read.isLegacy());
+        CHECK(read.entropyCoder() == EntropyCoder::ARITHMETIC);
+        CHECK(reader.position() == 0);
+    }
+
+    SECTION("unknown versions are not accepted") {
+        BitWriter writer;
+        writer.write(VC_PWQ::STREAM_MAGIC, VC_PWQ::STREAM_MAGIC_BITS);
+        writer.write(VC_PWQ::STREAM_VERSION + 1, VC_PWQ::BYTE_SIZE);
+        writer.write(0, VC_PWQ::BYTE_SIZE);
+
+        BitReader reader(writer);
+        StreamHeader read;
+        CHECK(!VC_PWQ::readStreamHeader(reader, read));
+        CHECK(reader.position() == 0);
+    }
+
+    SECTION("slice index is read back behind the byte-aligned padding") {
+        VC_PWQ::SliceIndex index;
+        index.slice_blocks = 4;
+        index.offsets = {0, 17, 40};  // NOLINT
+        BitWriter writer;
+        writer.write(0x5, 3);  // NOLINT
+        VC_PWQ::writeSliceIndex(index, writer);
+        REQUIRE(writer.size() % VC_PWQ::BYTE_SIZE == 0);
+        writer.write(0, 41 * VC_PWQ::BYTE_SIZE);  // NOLINT
+
+        BitReader reader(writer);
+        reader.skip(3);
+        VC_PWQ::SliceIndex read;
+        REQUIRE(VC_PWQ::readSliceIndex(reader, read));
+        CHECK(read.slice_blocks == 4);
+        CHECK(read.offsets == index.offsets);
+        CHECK(reader.position() % VC_PWQ::BYTE_SIZE == 0);
+    }
+
+    SECTION("container info is read back") {
+        VC_PWQ::ContainerInfo info;
+        info.fs = 44100;               // NOLINT
+        info.bl = 512;                 // NOLINT
+        info.channels = 3;             // NOLINT
+        info.samples = 5000000000ULL;  // NOLINT
+        BitWriter writer;
+        VC_PWQ::writeContainerInfo(info, writer);
+
+        BitReader reader(writer);
+        VC_PWQ::ContainerInfo read;
+        REQUIRE(VC_PWQ::readContainerInfo(reader, read));
+        CHECK(read.fs == info.fs);
+        CHECK(read.bl == info.bl);
+        CHECK(read.channels == info.channels);
+        CHECK(read.samples == info.samples);
+
+        BitReader cut = reader.sub(0, writer.size() - 1);
+        CHECK(!VC_PWQ::readContainerInfo(cut, read));
+    }
+
+    SECTION("slice offsets behind the end of the stream are rejected") {
+        VC_PWQ::SliceIndex index;
+        index.slice_blocks = 1;
+        index.offsets = {0, 100};  // NOLINT
+        BitWriter writer;
+        VC_PWQ::writeSliceIndex(index, writer);
+        writer.write(0, 10 * VC_PWQ::BYTE_SIZE);  // NOLINT
+
+        BitReader reader(writer);
+        VC_PWQ::SliceIndex read;
+        CHECK(!VC_PWQ::readSliceIndex(reader, read));
+    }
+}
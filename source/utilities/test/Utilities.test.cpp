@@ -12,7 +12,11 @@
 #include "../include/Utilities.hpp"
 
 #include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include <catch2/catch_all.hpp>
@@ -60,3 +64,104 @@ TEST_CASE("UniformQuant") {
         }
     }
 }
+
+TEST_CASE("saveToBuffer") {
+
+    VC_PWQ::BitWriter bits;
+    bits.write(0x2A5, 11);  // NOLINT
+
+    SECTION("bitstream fits") {
+        std::vector<uint8_t> out(3, 0xFF);  // NOLINT
+        CHECK(VC_PWQ::saveToBuffer(bits, out.data(), out.size()));
+        CHECK(out[0] == 0xA5);
+        CHECK(out[1] == 0x02);
+        CHECK(out[2] == 0xFF);
+    }
+
+    SECTION("buffer too small") {
+        std::vector<uint8_t> out(1, 0xFF);  // NOLINT
+        CHECK(!VC_PWQ::saveToBuffer(bits, out.data(), out.size()));
+        CHECK(out[0] == 0xFF);
+    }
+}
+
+TEST_CASE("readTXTMatrix") {
+
+    const std::string name = (std::filesystem::temp_directory_path() / "vcpwq_matrix.txt").string();
+    auto writeFile = [&](const std::string& content) {
+        std::ofstream out(name, std::ofstream::binary);
+        out << content;
+    };
+    std::vector<std::vector<double>> buffer;
+
+    SECTION("one channel per column") {
+        writeFile("1.5,-2\r\n3e-2, +4\r\n\r\n5,6\r\n");
+        REQUIRE(VC_PWQ::readTXTMatrix(buffer, name) == 1);
+        REQUIRE(buffer.size() == 2);
+        CHECK(buffer[0] == std::vector<double>{1.5, 3e-2, 5});  // NOLINT
+        CHECK(buffer[1] == std::vector<double>{-2, 4, 6});      // NOLINT
+    }
+
+    SECTION("one channel per row") {
+        writeFile("  1  2 3 4\n5 6 7\n");
+        REQUIRE(VC_PWQ::readTXTMatrix(buffer, name) == 1);
+        REQUIRE(buffer.size() == 2);
+        CHECK(buffer[0] == std::vector<double>{1, 2, 3, 4});  // NOLINT
+        CHECK(buffer[1] == std::vector<double>{5, 6, 7, 0});  // NOLINT
+    }
+
+    SECTION("rows longer than the first row") {
+        writeFile("1 2\n3 4 5\n6 7 8\n9 10 11\n");
+        REQUIRE(VC_PWQ::readTXTMatrix(buffer, name) == 1);
+        REQUIRE(buffer.size() == 3);
+        CHECK(buffer[0] == std::vector<double>{1, 3, 6, 9});   // NOLINT
+        CHECK(buffer[1] == std::vector<double>{2, 4, 7, 10});  // NOLINT
+        CHECK(buffer[2] == std::vector<double>{0, 5, 8, 11});  // NOLINT
+    }
+
+    SECTION("delimiter after leading empty lines") {
+        writeFile("\n\r\n1,2\n3,4\n5,6\n");
+        REQUIRE(VC_PWQ::readTXTMatrix(buffer, name) == 1);
+        REQUIRE(buffer.size() == 2);
+        CHECK(buffer[0] == std::vector<double>{1, 3, 5});  // NOLINT
+        CHECK(buffer[1] == std::vector<double>{2, 4, 6});  // NOLINT
+    }
+
+    SECTION("tab delimiter and invalid values") {
+        writeFile("1\tx\n2\t\n3\t4\n");
+        REQUIRE(VC_PWQ::readTXTMatrix(buffer, name) == 1);
+        REQUIRE(buffer.size() == 2);
+        CHECK(buffer[0] == std::vector<double>{1, 2, 3});  // NOLINT
+        CHECK(buffer[1] == std::vector<double>{0, 0, 4});  // NOLINT
+    }
+
+    SECTION("empty and missing files") {
+        writeFile("");
+        CHECK(VC_PWQ::readTXTMatrix(buffer, name) == 0);
+        std::remove(name.c_str());
+        CHECK(VC_PWQ::readTXTMatrix(buffer, name) == 0);
+        CHECK(buffer.empty());
+    }
+
+    std::remove(name.c_str());
+}
+
+TEST_CASE("copyBlock") {
+
+    // two interleaved channels of 5 samples
+    const std::vector<double> interleaved = {1, 10, 2, 20, 3, 30, 4, 40, 5, 50};  // NOLINT
+    std::vector<double> block(4);
+
+    SECTION("samples behind the end of the channel are zero") {
+        VC_PWQ::copyBlock({interleaved.data() + 1, 5, 2}, 4, block);  // NOLINT
+        CHECK(block == std::vector<double>{50, 0, 0, 0});           // NOLINT
+        VC_PWQ::copyBlock({interleaved.data(), 5, 2}, 0, block);      // NOLINT
+        CHECK(block == std::vector<double>{1, 2, 3, 4});              // NOLINT
+    }
+
+    SECTION("blocks behind the end of a shorter channel are zero") {
+        block.assign(block.size(), 7);                               // NOLINT
+        VC_PWQ::copyBlock({interleaved.data() + 1, 5, 2}, 8, block);  // NOLINT
+        CHECK(block == std::vector<double>(4, 0));
+    }
+}
@@ -27,12 +27,15 @@ static constexpr double h3 = 0.8829110755411875;
 static constexpr double h4 = 0.4435068520511142;
 static constexpr double scaleFactor = 1.1496043988602418;
 
-void filter(std::vector<double> in, std::vector<double>& out, double h);
-void filter_shift(std::vector<double> in, std::vector<double>& out, double h);
+void filter(const std::vector<double>& in, std::vector<double>& out, double h);
+void filter_shift(const std::vector<double>& in, std::vector<double>& out, double h);
 
 auto DWT(std::vector<double> in, int level) -> std::vector<double>;
 auto inv_DWT(std::vector<double> in, int level) -> std::vector<double>;
 
+void DWT_inplace(double* data, int length, int level, double* scratch);
+void inv_DWT_inplace(double* data, int length, int level, double* scratch);
+
 }  // namespace VC_PWQ
 
 #endif /* Wavelet_hpp */
@@ -13,99 +13,84 @@
 
 #include "../include/Wavelet.hpp"
 
+#include "../../utilities/include/Simd.hpp"
+
 namespace VC_PWQ {
 
-void filter(std::vector<double> in, std::vector<double>& out, double h) {
-    for (auto& v : in) {
-        v = v * h;
-    }
-    std::transform(
-        in.begin(), in.end(), out.begin(), out.begin(), [](double add, double v) -> double { return v + add; });
-    std::transform(in.begin(), in.end() - 1, out.begin() + 1, out.begin() + 1, [](double add, double v) -> double {
-        return v + add;
-    });
-    out[0] = out[0] + in[0];
+void filter(const std::vector<double>& in, std::vector<double>& out, double h) {
+    Simd::lift(in.data(), out.data(), (int)in.size(), h);
 }
 
-void filter_shift(std::vector<double> in, std::vector<double>& out, double h) {
-    for (auto& v : in) {
-        v = v * h;
-    }
-    std::transform(
-        in.begin() + 1, in.end(), out.begin(), out.begin(), [](double add, double v) -> double { return v + add; });
-    size_t end = in.size() - 1;
-    out[end] = out[end] + in[end];
-    std::transform(in.begin() + 1, in.end(), out.begin() + 1, out.begin() + 1, [](double add, double v) -> double {
-        return v + add;
-    });
-    out[0] = out[0] + in[0];
+void filter_shift(const std::vector<double>& in, std::vector<double>& out, double h) {
+    Simd::liftShift(in.data(), out.data(), (int)in.size(), h);
 }
 
 auto DWT(std::vector<double> in, int level) -> std::vector<double> {
+    std::vector<double> scratch(in.size());
+    DWT_inplace(in.data(), (int)in.size(), level, scratch.data());
+    return in;
+}
 
-    auto n = (int)in.size();
+auto inv_DWT(std::vector<double> in, int level) -> std::vector<double> {
+    std::vector<double> scratch(in.size());
+    inv_DWT_inplace(in.data(), (int)in.size(), level, scratch.data());
+    return in;
+}
+
+/**
+ * @brief CDF 9/7 wavelet transform in place
+ * @details splitting is fused with the first lifting step and the last lifting step with the scaling; every step is
+ * a single pass over the coefficients using the vectorized kernels
+ * @param data signal, replaced by the wavelet coefficients (approximation first, then details of decreasing level)
+ * @param length signal length, divisible by 2^level
+ * @param level number of decomposition levels
+ * @param scratch buffer of at least length values
+ */
+void DWT_inplace(double* data, int length, int level, double* scratch) {
+
+    int n = length;
 
     for (int k = 1; k <= level; k++) {
 
-        std::vector<double> X0;
-        std::vector<double> X1;
         int n_half = n / 2;
-        X0.reserve(n_half);
-        X1.reserve(n_half);
-        for (auto it = in.begin(); it < in.begin() + n; it += 2) {
-            X0.push_back(*it);
-        }
-        int i = 0;
-        for (auto it = in.begin() + 1; it < in.begin() + n; it += 2) {
-            X1.push_back(*it);
-        }
-
-        filter_shift(X0, X1, h1);
-        filter(X1, X0, h2);
-        filter_shift(X0, X1, h3);
-        filter(X1, X0, h4);
-
-        std::transform(X0.begin(), X0.end(), in.begin(), [](double v) -> double { return v * scaleFactor; });
-        std::transform(X1.begin(), X1.end(), in.begin() + n_half, [](double v) -> double { return -v / scaleFactor; });
+        double* X0 = scratch;
+        double* X1 = scratch + n_half;
+
+        Simd::splitPredict(data, X0, X1, n_half, h1);
+        Simd::lift(X1, X0, n_half, h2);
+        Simd::liftShift(X0, X1, n_half, h3);
+        Simd::updateScale(X0, X1, data, n_half, h4, scaleFactor);
 
         n = n_half;
     }
-    return in;
 }
 
-auto inv_DWT(std::vector<double> in, int level) -> std::vector<double> {
+/**
+ * @brief inverse CDF 9/7 wavelet transform in place
+ * @details the scaling is fused with the first lifting step and the last lifting step with the merging; every step is
+ * a single pass over the coefficients using the vectorized kernels
+ * @param data wavelet coefficients, replaced by the signal
+ * @param length signal length, divisible by 2^level
+ * @param level number of decomposition levels
+ * @param scratch buffer of at least length values
+ */
+void inv_DWT_inplace(double* data, int length, int level, double* scratch) {
 
-    auto n = (int)((double)in.size() * (double)pow(2, 1 - level));
+    int n = (level > 0) ? (length >> (level - 1)) : length;
 
     for (int k = 1; k <= level; k++) {
 
         int n_half = n / 2;
-        std::vector<double> X0(n_half, 0);
-        std::vector<double> X1(n_half, 0);
-
-        std::transform(in.begin(), in.begin() + n_half, X0.begin(), [](double v) -> double { return v / scaleFactor; });
-        std::transform(
-            in.begin() + n_half, in.begin() + n, X1.begin(), [](double v) -> double { return -v * scaleFactor; });
-
-        filter(X1, X0, -h4);
-        filter_shift(X0, X1, -h3);
-        filter(X1, X0, -h2);
-        filter_shift(X0, X1, -h1);
-
-        auto it_0 = X0.begin();
-        for (auto it = in.begin(); it < in.begin() + n; it += 2) {
-            *it = *it_0;
-            it_0++;
-        }
-        auto it_1 = X1.begin();
-        for (auto it = in.begin() + 1; it < in.begin() + n; it += 2) {
-            *it = *it_1;
-            it_1++;
-        }
+        double* X0 = scratch;
+        double* X1 = scratch + n_half;
+
+        Simd::unscaleUpdate(data, X0, X1, n_half, -h4, scaleFactor);
+        Simd::liftShift(X0, X1, n_half, -h3);
+        Simd::lift(X1, X0, n_half, -h2);
+        Simd::predictMerge(X0, X1, data, n_half, -h1);
 
         n = n * 2;
     }
-    return in;
 }
 
 }  // namespace VC_PWQ
@@ -16,6 +16,56 @@
 
 #include <catch2/catch_all.hpp>
 
+namespace {
+
+struct GoldenTransform {
+    int bl;
+    int level;
+    std::vector<double> forward;  // of the samples (i * 37) % 11 - 5
+    std::vector<double> inverse;  // of the coefficients (i * 13) % 7 - 3
+};
+
+// output of the original transform built from filter and filter_shift, as exact hexadecimal literals
+// NOLINTBEGIN
+const std::vector<GoldenTransform> goldenTransforms = {
+    {8,
+     1,
+     {-0x1.5f70a30dd7b32p+2, 0x1.27146c62324dfp+0, -0x1.35e4056869be8p-2, -0x1.ce47f4415df71p-3,
+      -0x1.c76fdd434ab3dp-2, 0x1.42fb78b0d8ae7p+2, -0x1.21f03b246cb19p+2, -0x1.7c5ae548d03bcp+1},
+     {-0x1.47ec28113c6bbp+1, -0x1.47826b919c688p-2, 0x1.09c8dcd5d71f4p+1, 0x1.7b73e56649831p+1,
+      0x1.6a09e6678cd7bp-2, 0x1.2ad6ba0c82311p+1, -0x1.26280b34a489ap+0, 0x1.6277e8d23b03cp+1}},
+    {16,
+     2,
+     {-0x1.bbf743043c99bp+1, 0x1.d7226afb96911p-3, 0x1.269d6ec742f67p+1, -0x1.3bdce57519c2bp+1,
+      -0x1.b9becd11ddf83p+1, 0x1.6437422798394p+1, 0x1.3c9c5b71f5f8dp+1, -0x1.ccff348663fd4p-2,
+      -0x1.c76fdd434ab3dp-2, 0x1.42fb78b0d8ae7p+2, -0x1.42fb78b0d8ae7p+2, -0x1.8e65de026615bp-40,
+      0x1.265643088cd47p+2, 0x1.158c040fc4964p+2, -0x1.21f03b246c4ep+2, -0x1.7c5ae548cf749p+1},
+     {0x1.667626a732abep-3, -0x1.b7e4615ddf963p+1, 0x1.8f26c1498007bp+0, -0x1.55fc914ac927p-1,
+      0x1.4b8ed35cd26bfp+1, 0x1.65f606783224cp+0, 0x1.4bcab56e01d54p+1, 0x1.1a40e9bbb839p+0,
+      -0x1.295ee47ca01f2p-2, 0x1.b6c02ebdfb3afp+0, 0x1.a008eaeed3ad3p-1, 0x1.718df639bc121p+0,
+      -0x1.8631eda60a628p+1, 0x1.958247996c5cp+1, 0x1.1e517c59f6be1p+1, -0x1.36918e3e5ef08p-1}},
+    {32,
+     3,
+     {-0x1.84d4cb79550c2p+1, 0x1.43f89288370f2p+0, -0x1.3f10832fa067cp-5, -0x1.4abc28bedd49fp-2,
+      -0x1.0205d8ee1e7a3p+0, 0x1.191c24eeda8d3p+2, 0x1.48ad81678308bp-3, -0x1.9ce4f51006807p+0,
+      -0x1.b9becd11ddf83p+1, 0x1.61b74227981c1p+1, 0x1.2b8a241a2e7e7p+1, 0x1.f742142f6bda2p+0,
+      0x1.4f8067940377ap-1, 0x1.0bac224850b24p+2, -0x1.2ebe0010fecebp-5, -0x1.bc72d0319fefdp+1,
+      -0x1.c76fdd434ab3dp-2, 0x1.42fb78b0d8ae7p+2, -0x1.42fb78b0d8ae7p+2, -0x1.8e65de026615bp-40,
+      0x1.265643088cd47p+2, 0x1.158c040fc4964p+2, -0x1.42fb78b0d84afp+2, -0x0p+0,
+      0x1.42fb78b0d84afp+2, -0x1.158c040fc4964p+2, -0x1.265643088cd47p+2, 0x1.8e65de026615bp-40,
+      0x1.42fb78b0d8ae7p+2, -0x1.42fb78b0d8ae7p+2, -0x1.8c86e2951c4c9p-3, 0x1.8e7f136cb1277p+2},
+     {0x1.e12cf64961f48p+0, -0x1.53b126c1df79fp+1, -0x1.b2208e6f99b38p+0, -0x1.6c23e747b0536p+0,
+      0x1.bffd85a4dc1e1p+0, 0x1.b57fa9c3c22d8p-2, -0x1.0c8ef702d945fp+0, 0x1.51e8a55b51123p+0,
+      0x1.e770fcae1c405p-1, 0x1.58ae7d246ffecp+1, -0x1.0b05a7324cf6ap+0, 0x1.03e617e8318fbp+2,
+      0x1.f12d1c503ee53p+0, -0x1.285d92fc449bap+0, 0x1.5aee89faabcaep+1, -0x1.1677b292c0f78p+0,
+      0x1.6f25b37b5aa6ep-1, -0x1.e270012165598p-3, 0x1.af04e6cf581f2p+0, 0x1.f6b6548af173cp-1,
+      0x1.44f4f2c1cb7f6p-3, 0x1.bc8bf67e21f2p+0, 0x1.5931096139f02p-3, 0x1.c5b9657074bacp-3,
+      -0x1.21a99513f2bp+2, 0x1.38c0b7c4e1d94p+1, 0x1.43f6f180877ebp+1, -0x1.1501896adbd2p-3,
+      0x1.cc0f7978f81f5p+1, -0x1.6ae4c0127fd38p-1, 0x1.df9659e33089bp-2, -0x1.6ee080225ad61p+0}}};
+// NOLINTEND
+
+}  // namespace
+
 TEST_CASE("Wavelet transformation") {
 
     using VC_PWQ::DWT;
@@ -24,4 +74,37 @@ TEST_CASE("Wavelet transformation") {
     SECTION("Input/Output test") {
         CHECK(true);
     }
+
+    SECTION("perfect reconstruction") {
+        static constexpr int bl = 128;
+        static constexpr int level = 5;
+        std::vector<double> sig(bl);
+        for (int i = 0; i < bl; i++) {
+            sig[i] = sin(0.1 * i) + 0.5 * cos(2.3 * i);  // NOLINT
+        }
+        std::vector<double> rec = inv_DWT(DWT(sig, level), level);
+        REQUIRE(rec.size() == sig.size());
+        for (int i = 0; i < bl; i++) {
+            CHECK(rec[i] == Catch::Approx(sig[i]).margin(1e-12));  // NOLINT
+        }
+    }
+
+    SECTION("lifting kernels match the baseline filter transform") {
+        for (const auto& golden : goldenTransforms) {
+            const int bl = golden.bl;
+            std::vector<double> scratch(bl);
+            std::vector<double> data(bl);
+            for (int i = 0; i < bl; i++) {
+                data[i] = (double)((i * 37) % 11) - 5;  // NOLINT
+            }
+            VC_PWQ::DWT_inplace(data.data(), bl, golden.level, scratch.data());
+            CHECK(data == golden.forward);
+
+            for (int i = 0; i < bl; i++) {
+                data[i] = (double)((i * 13) % 7) - 3;  // NOLINT
+            }
+            VC_PWQ::inv_DWT_inplace(data.data(), bl, golden.level, scratch.data());
+            CHECK(data == golden.inverse);
+        }
+    }
 }